@@ -0,0 +1,74 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _CACHE_DIRECTORY_RENDERER_APP_H_
+#define _CACHE_DIRECTORY_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+#include <map>
+#include <mutex>
+
+/*! \class %CacheDirectory
+ * \brief %CacheDirectory class.
+ *
+ *  Location of the binary cache files and of the sequence indexes. By default the files are written in the .binary
+ *  directory next to the sources. With a cache directory (--cacheDir), the binary files are named by a fingerprint of
+ *  the content and of the modification time of their source and of the duplicate points mode, so the copies of a
+ *  sequence that keep its times share their entries, and the least recently used entries are evicted when the
+ *  directory exceeds its size.
+ *
+ *  Several processes can use the same directory: the entries are written in temporary files renamed once complete,
+ *  the readers only map the files and update their modification time, used as the LRU order.
+ */
+class CacheDirectory {
+ public:
+  static CacheDirectory& getInstance();
+
+  /**
+   * \brief use a cache directory.
+   * \param sDirectory Cache directory, created if needed. Empty to write the files next to the sources.
+   * \param iMaxSize Size of the directory above which the least recently used entries are evicted, 0: no limit.
+   */
+  void setDirectory( const std::string& sDirectory, uint64_t iMaxSize );
+
+  inline bool               isEnabled() const { return !m_sDirectory.empty(); }
+  inline const std::string& getDirectory() const { return m_sDirectory; }
+
+  //! Name of the binary cache file of a source point cloud.
+  std::string getBinaryName( const std::string& sSource, int iDropDups, bool bMortonOrder );
+  //! Name of the index of a sequence given by its file pattern or directory.
+  std::string getIndexName( const std::string& sSequence, int iDropDups );
+
+  //! Mark an entry as used: it becomes the most recently used one.
+  void touch( const std::string& sFilename );
+  //! Account an entry written by the CacheWriter and evict the least recently used entries if needed.
+  void add( const std::string& sFilename, uint64_t iSize );
+
+  //! Unique temporary name used to write a file before its rename.
+  static std::string getTemporaryName( const std::string& sFilename );
+
+ private:
+  CacheDirectory();
+  ~CacheDirectory();
+  CacheDirectory( const CacheDirectory& ) = delete;
+  CacheDirectory& operator=( const CacheDirectory& ) = delete;
+  bool            getFingerprint( const std::string& sSource, uint64_t& iFingerprint );
+  uint64_t        evict( uint64_t iTargetSize );
+
+  //! Fingerprint of a source, computed again if the source has changed.
+  struct Fingerprint {
+    uint64_t m_iSize        = 0;
+    int64_t  m_iTime        = 0;
+    uint64_t m_iFingerprint = 0;
+  };
+  std::string                        m_sDirectory;
+  uint64_t                           m_iMaxSize = 0;
+  uint64_t                           m_iSize    = 0;
+  bool                               m_bScanned = false;
+  std::map<std::string, Fingerprint> m_pFingerprints;
+  std::mutex                         m_eMutex;
+};
+
+#endif  //~_CACHE_DIRECTORY_RENDERER_APP_H_
@@ -0,0 +1,51 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _CACHE_WRITER_RENDERER_APP_H_
+#define _CACHE_WRITER_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*! \class %CacheWriter
+ * \brief %CacheWriter class.
+ *
+ *  Write-behind thread of the binary cache files. The readers serialize the frames in memory and push the buffers,
+ *  the files are written in a temporary file and renamed by a background thread so the first read of a sequence is
+ *  not slowed down by the writes. The pending buffers are written before the end of the process.
+ */
+class CacheWriter {
+ public:
+  static CacheWriter& getInstance();
+
+  /**
+   * \brief queue a buffer to write.
+   * \param sFilename Name of the cache file.
+   * \param pBuffer Content of the file, moved in the queue.
+   */
+  void push( const std::string& sFilename, std::vector<uint8_t>&& pBuffer );
+  //! Wait until all the queued buffers are written.
+  void flush();
+
+ private:
+  CacheWriter();
+  ~CacheWriter();
+  CacheWriter( const CacheWriter& ) = delete;
+  CacheWriter& operator=( const CacheWriter& ) = delete;
+  void         process();
+
+  std::deque<std::pair<std::string, std::vector<uint8_t>>> m_eQueue;
+  size_t                                                   m_iPendingSize = 0;
+  bool                                                     m_bStop        = false;
+  bool                                                     m_bWriting     = false;
+  std::thread                                              m_eThread;
+  std::mutex                                               m_eMutex;
+  std::condition_variable                                  m_eCondition;
+};
+
+#endif  //~_CACHE_WRITER_RENDERER_APP_H_
@@ -0,0 +1,110 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _DECOMPRESSOR_RENDERER_APP_H_
+#define _DECOMPRESSOR_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*! \class %Decompressor
+ * \brief %Decompressor class.
+ *
+ *  Decompression of the gzip (.gz) and zstd (.zst) files by a background thread: the format is detected from the first
+ *  bytes of the file and the decompressed data are delivered by blocks through a bounded queue, so the parser decodes
+ *  a block while the next ones are decompressed. The formats are supported when the renderer is built with zlib
+ *  (USE_ZLIB) and libzstd (USE_ZSTD).
+ */
+class Decompressor {
+ public:
+  Decompressor();
+  ~Decompressor();
+
+  //! Open the file and start the decompression thread. \return False if the format is not supported.
+  bool open( const std::string& sFilename );
+
+  /**
+   * \brief get the next decompressed block, waits for the decompression thread if the queue is empty.
+   * \param pBlock Block to fill, its previous buffer is reused by the decompression thread.
+   * \return False at the end of the data.
+   */
+  bool read( std::vector<uint8_t>& pBlock );
+
+  /**
+   * \brief wait for the end of the decompression, the blocks that have not been read are dropped.
+   * \return True if the file is truncated or corrupted: the data returned by read() are incomplete or wrong.
+   */
+  bool getError();
+  void close();
+
+ private:
+  enum Format { FORMAT_UNKNOWN = 0, FORMAT_GZIP, FORMAT_ZSTD };
+  Decompressor( const Decompressor& ) = delete;
+  Decompressor& operator=( const Decompressor& ) = delete;
+  void          process();
+  bool          decompressGzip();
+  bool          decompressZstd();
+  size_t        readInput( std::vector<uint8_t>& pInput );
+  void          getFreeBlock( std::vector<uint8_t>& pBlock );
+  bool          push( std::vector<uint8_t>& pBlock );
+
+  std::string                       m_sFilename;
+  std::ifstream                     m_eFile;
+  Format                            m_eFormat = FORMAT_UNKNOWN;
+  std::deque<std::vector<uint8_t>>  m_eQueue;
+  std::vector<std::vector<uint8_t>> m_pFree;
+  bool                              m_bEnd   = false;
+  bool                              m_bError = false;
+  bool                              m_bStop  = false;
+  std::thread                       m_eThread;
+  std::mutex                        m_eMutex;
+  std::condition_variable           m_eCondition;
+};
+
+/*! \class %DecompressedStream
+ * \brief %DecompressedStream class.
+ *
+ *  Input stream over the blocks of a %Decompressor, used by the stream parsers (PLY header, tinyply, tinyobj). Only the
+ *  current block is kept in memory, unless the stream is opened as seekable for the parsers that read the data twice.
+ */
+class DecompressedStream : public std::istream {
+ public:
+  DecompressedStream();
+  ~DecompressedStream();
+
+  //! Open the compressed file. \param bSeekable Keep the decompressed data to allow the backward seeks.
+  bool        open( const std::string& sFilename, bool bSeekable = false );
+  void        close();
+  inline bool is_open() const { return m_bOpen; }
+  //! True if the file is truncated or corrupted, called once the data are parsed: see Decompressor::getError().
+  inline bool getError() { return m_eBuffer.getError(); }
+
+ private:
+  class Buffer : public std::streambuf {
+   public:
+    bool        open( const std::string& sFilename, bool bSeekable );
+    void        close();
+    inline bool getError() { return m_eDecompressor.getError(); }
+
+   protected:
+    int_type underflow() override;
+    pos_type seekoff( off_type iOffset, std::ios_base::seekdir eDirection, std::ios_base::openmode eMode ) override;
+    pos_type seekpos( pos_type iPosition, std::ios_base::openmode eMode ) override;
+
+   private:
+    Decompressor         m_eDecompressor;
+    std::vector<uint8_t> m_pData;
+    std::vector<uint8_t> m_pBlock;
+    uint64_t             m_iDataPosition = 0;  // position of m_pData[0] in the decompressed data
+    bool                 m_bSeekable     = false;
+  };
+  Buffer m_eBuffer;
+  bool   m_bOpen = false;
+};
+
+#endif  //~_DECOMPRESSOR_RENDERER_APP_H_
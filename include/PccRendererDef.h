@@ -29,6 +29,9 @@
 #include <memory>
 #include <iomanip>
 #include <functional>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef WIN32
 #include <windows.h>
@@ -127,6 +130,8 @@ typedef glm::quat   Quaternion;
 typedef glm::vec3   Point;
 typedef glm::vec3   Color3;
 typedef glm::vec4   Color4;
+typedef glm::u8vec3 Color3u8;
+typedef glm::u8vec4 Color4u8;
 typedef glm::vec3   Normal;
 
 // PROGRESSBAR PRINT
@@ -166,6 +171,14 @@ static inline bool exist( const std::string& pString ) {
   return ( stat( pString.c_str(), &buffer ) == 0 );
 }
 
+static bool getFileStatus( const std::string& pString, uint64_t& iSize, int64_t& iTime ) {
+  struct stat buffer;
+  if ( stat( pString.c_str(), &buffer ) != 0 ) { return false; }
+  iSize = static_cast<uint64_t>( buffer.st_size );
+  iTime = static_cast<int64_t>( buffer.st_mtime );
+  return true;
+}
+
 static bool dirExists( const std::string& pString ) {
   struct stat sb;
   if ( stat( pString.c_str(), &sb ) == 0
@@ -212,6 +225,21 @@ static std::string getRemoveExtension( const std::string& eFilename ) {
   return eFilename;
 }
 
+// The gzip (.gz) and zstd (.zst) files are decompressed while they are read.
+static bool isCompressed( const std::string& eFilename ) {
+  const std::string sExtension = getExtension( eFilename );
+  return sExtension == "gz" || sExtension == "zst";
+}
+
+// Extension of the decompressed content: "ply" for "frame.ply" and "frame.ply.gz".
+static std::string getContentExtension( const std::string& eFilename ) {
+  return getExtension( isCompressed( eFilename ) ? getRemoveExtension( eFilename ) : eFilename );
+}
+
+static std::string getRemoveContentExtension( const std::string& eFilename ) {
+  return getRemoveExtension( isCompressed( eFilename ) ? getRemoveExtension( eFilename ) : eFilename );
+}
+
 static std::string getDirectory( const std::string& string ) {
   auto position = string.find_last_of( getSeparator( string ) );
   if ( position != std::string::npos ) { return string.substr( 0, position ); }
@@ -224,9 +252,18 @@ static std::string getBasename( const std::string& string ) {
   return string;
 }
 
-static std::string getBinaryName( const std::string& eFilename, int iDropDups ) {
+static std::string getBinaryName( const std::string& eFilename, int iDropDups, bool bMortonOrder = false ) {
   return getDirectory( eFilename ) + getSeparator() + ".binary" + getSeparator() +
-         getRemoveExtension( getBasename( eFilename ) ) + stringFormat( "_dup%d.bpcfi", iDropDups );
+         getRemoveExtension( getBasename( eFilename ) ) +
+         stringFormat( "_dup%d%s.bpcc", iDropDups, bMortonOrder ? "_morton" : "" );
+}
+
+// Name of the index of a sequence: the '%' of the file patterns are replaced to get a valid filename.
+static std::string getIndexName( const std::string& eFilename, int iDropDups ) {
+  std::string sBasename = getRemoveExtension( getBasename( eFilename ) );
+  std::replace( sBasename.begin(), sBasename.end(), '%', '#' );
+  return getDirectory( eFilename ) + getSeparator() + ".binary" + getSeparator() + sBasename +
+         stringFormat( "_dup%d.bpcsi", iDropDups );
 }
 
 static void trace( Mat4& mat ) {
@@ -244,6 +281,48 @@ static void trace( Vec3& vec ) { printf( "Vec3   %12.8f %12.8f %12.8f \n", vec[0
     file = nullptr;    \
   }
 
+// Conversion of the color components of the PLY files, in [0;255], to the 8-bit colors stored in memory.
+static inline uint8_t  toColor8Bit( float fValue ) { return static_cast<uint8_t>( CLIP( fValue + 0.5f, 0.f, 255.f ) ); }
+static inline Color3u8 toColor8Bit( const Color3& eColor ) {
+  return Color3u8( toColor8Bit( eColor[0] ), toColor8Bit( eColor[1] ), toColor8Bit( eColor[2] ) );
+}
+static inline Color4u8 toColor8Bit( const Color4& eColor ) {
+  return Color4u8( toColor8Bit( eColor[0] ), toColor8Bit( eColor[1] ), toColor8Bit( eColor[2] ),
+                   toColor8Bit( eColor[3] ) );
+}
+
+/**
+ * \brief run pFunction( i ) for i in [0;iCount[ as OpenMP tasks and wait for their completion.
+ *
+ * In a parallel region, the tasks are added to the task pool of the team: the idle threads steal them with the other
+ * pending tasks, as the frames of the other inputs or the chunks of the other frames. Otherwise, a parallel region is
+ * created to execute the tasks. Without OpenMP, the functions are called sequentially.
+ */
+template <typename Function>
+void runTasks( int iCount, const Function& pFunction ) {
+#ifdef _OPENMP
+  if ( omp_in_parallel() ) {
+#pragma omp taskloop grainsize( 1 ) shared( pFunction )
+    for ( int i = 0; i < iCount; i++ ) { pFunction( i ); }
+  } else {
+#pragma omp parallel
+#pragma omp single
+#pragma omp taskloop grainsize( 1 ) shared( pFunction )
+    for ( int i = 0; i < iCount; i++ ) { pFunction( i ); }
+  }
+#else
+  for ( int i = 0; i < iCount; i++ ) { pFunction( i ); }
+#endif
+}
+
+//! Run pFunction( iBegin, iEnd ) on the chunks of iChunkSize elements of [0;iCount[ with runTasks().
+template <typename Function>
+void runChunkTasks( size_t iCount, size_t iChunkSize, const Function& pFunction ) {
+  runTasks( static_cast<int>( ( iCount + iChunkSize - 1 ) / iChunkSize ), [&]( int c ) {
+    pFunction( c * iChunkSize, ( std::min )( iCount, ( c + 1 ) * iChunkSize ) );
+  } );
+}
+
 #define SHADER_VERSION "400"
 #define SHADER( shader ) "#version " SHADER_VERSION "\n" #shader
 
@@ -48,6 +48,10 @@ class Image {
     }
   }
 
+  inline void set( size_t i, size_t j, Color3u8 eColor ) {
+    for ( int c = 0; c < 3; c++ ) { m_eData[( j * m_iWidth + i ) * 3 + c] = static_cast<uint16_t>( eColor[c] * 257 ); }
+  }
+
   void copy( Image& eSrc, int iNbComp ) {
     allocate( eSrc.m_iWidth, eSrc.m_iHeight, iNbComp );
     if ( m_iNbComp == eSrc.m_iNbComp ) {
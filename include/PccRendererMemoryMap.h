@@ -0,0 +1,45 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _MEMORY_MAP_RENDERER_APP_H_
+#define _MEMORY_MAP_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+/*! \class %MemoryMap
+ * \brief %MemoryMap class.
+ *
+ *  Read-only mapping of a whole file in the address space of the process. The mapping is released when the object is
+ *  destroyed or closed. On failure, data() returns nullptr and the callers must fall back on the stream readers.
+ */
+class MemoryMap {
+ public:
+  MemoryMap();
+  MemoryMap( const MemoryMap& ) = delete;
+  MemoryMap& operator=( const MemoryMap& ) = delete;
+  ~MemoryMap();
+
+  /**
+   * \brief map the file in memory.
+   * \param sFilename Name of the file.
+   * \param bSequential Advise the kernel that the file will be read sequentially.
+   * \return True if the file has been mapped.
+   */
+  bool open( const std::string& sFilename, bool bSequential = true );
+  void close();
+
+  inline bool           isOpen() const { return m_pData != nullptr; }
+  inline const uint8_t* data() const { return m_pData; }
+  inline size_t         size() const { return m_iSize; }
+
+ private:
+  const uint8_t* m_pData = nullptr;
+  size_t         m_iSize = 0;
+#ifdef WIN32
+  HANDLE m_hFile    = INVALID_HANDLE_VALUE;
+  HANDLE m_hMapping = nullptr;
+#endif
+};
+
+#endif  //~_MEMORY_MAP_RENDERER_APP_H_
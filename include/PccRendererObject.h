@@ -12,6 +12,9 @@
 
 enum ObjectType { POINTCLOUD = 0, MESH = 1 };
 
+//! Optional attributes of the point clouds, the attributes that are not requested are skipped by the readers.
+enum PointAttribute { ATTRIBUTE_NORMAL = 1, ATTRIBUTE_TYPE = 2, ATTRIBUTE_MULTI_COLOR = 4, ATTRIBUTE_ALL = 7 };
+
 class Box {
  public:
   Box() {
@@ -41,6 +44,16 @@ class Box {
       if ( m_eMax[i] < point[i] ) { m_eMax[i] = point[i]; }
     }
   }
+  //! Bounding box of the eight corners transformed by a matrix.
+  Box transform( const Mat4& eMatrix ) const {
+    Box eBox;
+    for ( int i = 0; i < 8; i++ ) {
+      Vec4 eCorner( ( i & 1 ) ? m_eMax[0] : m_eMin[0], ( i & 2 ) ? m_eMax[1] : m_eMin[1],
+                    ( i & 4 ) ? m_eMax[2] : m_eMin[2], 1.f );
+      eBox.update( Vec3( eMatrix * eCorner ) );
+    }
+    return eBox;
+  }
 
  private:
   Vec3 m_eMin;
@@ -59,14 +72,15 @@ class Object {
                                            std::vector<Color3>& colors,
                                            std::vector<Vec3>&   directions ) = 0;
   virtual void               recomputeBoundingBox()                        = 0;
-  virtual void               center( Box box, float fBoxSize )             = 0;
-  virtual void               scale( Box box, float fBoxSize )              = 0;
   virtual void               sortVertex(const Camera& cam)                 = 0;
   virtual void               loadProgram()                                 = 0;
   virtual std::string        getInformation()                              = 0;
   inline int                 getFrameIndex() { return m_iFrameIndex; }
   inline float               getMaxDistance() { return m_fMaxDistance; }
   inline Box&                getBox() { return m_eBox; }
+  inline const Mat4&         getModel() { return m_eModel; }
+  inline void                setModel( const Mat4& eModel ) { m_eModel = eModel; }
+  inline Box                 getModelBox() { return m_eBox.transform( m_eModel ); }
   virtual Program&           getProgram()                            = 0;
   virtual int32_t            getProgramIndex()                       = 0;
   virtual void               setProgramIndex( int32_t programIndex ) = 0;
@@ -75,8 +89,9 @@ class Object {
 
   const std::string& getFilename() { return m_eFilename; }
   void               printBoundingBox( std::string string ) {
+    Box eBox = getModelBox();
     printf( "%s: Frame %4d: BB=[%8.2f;%8.2f][%8.2f;%8.2f][%8.2f;%8.2f] \n", string.c_str(), m_iFrameIndex,
-            m_eBox.min()[0], m_eBox.max()[0], m_eBox.min()[1], m_eBox.max()[1], m_eBox.min()[2], m_eBox.max()[2] );
+            eBox.min()[0], eBox.max()[0], eBox.min()[1], eBox.max()[1], eBox.min()[2], eBox.max()[2] );
   }
   void setCameraPosition( Vec3 eCameraPosition ) { m_eCameraPosition = eCameraPosition; }
   void setMultiColorIndex( int iMultiColorIndex ) { m_iMultiColorIndex = iMultiColorIndex; }
@@ -96,6 +111,7 @@ class Object {
   float       m_fMaxDistance      = 255.f;
   Vec3        m_eCameraPosition   = Vec3(0,0,0);
   Box         m_eBox;
+  Mat4        m_eModel    = Mat4( 1.f );  // normalization of the sequence, the positions are kept as read
   std::string m_eFilename = "";
   Object*     m_pcSource  = nullptr;
 };
@@ -82,8 +82,6 @@ class Mesh {
   Texture&              getTexture( size_t i ) { return m_eTexture[i]; }
   const Box&            getBox() { return m_eBox; }
   void                  recomputeBoundingBox();
-  void                  center( Vec3 center );
-  void                  scale( Vec3 center, float fScale );
   bool                  getUseColorPerVertex() { return m_bUseColorPerVertex; }
   void                  setUseColorPerVertex( bool bValue ) { m_bUseColorPerVertex = bValue; }
   size_t                getNumberOfVertices() { return m_eVertices.size(); }
@@ -119,8 +117,6 @@ class ObjectMesh : public Object {
   void               draw( bool lighting );
   void               loadProgram();
   void               recomputeBoundingBox();
-  void               center( Box box, float fBoxSize );
-  void               scale( Box box, float fBoxSize );
   bool               read( std::string path, int32_t framesIndex );
   void               sortVertex(const Camera& cam) {} //Stub. Needed for PCC rendering
   void               getRigPoints( std::vector<Vec3>&, std::vector<Color3>&, std::vector<Vec3>& ) {}
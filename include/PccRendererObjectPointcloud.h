@@ -8,6 +8,9 @@
 #include "PccRendererDef.h"
 #include "PccRendererObject.h"
 #include "PccRendererCamera.h"
+#include "PccRendererPointMemory.h"
+
+typedef float ( *CastFunction )( unsigned char* pPointer );
 
 /*! \class %ObjectPointcloud class
  * \brief %ObjectPointcloud class.
@@ -47,6 +50,8 @@ class RigParameters {
   std::vector<Mat4> m_eMatrix;
 };
 
+class SequenceContainer;
+
 class ObjectPointcloud : public Object {
  public:
   //! Constructor.
@@ -64,11 +69,10 @@ class ObjectPointcloud : public Object {
              int                       iFrameIndex,
              bool                      bBinary,
              int                       iDropDups,
+             bool                      bMortonOrder,
              std::vector<std::string>& pTypeName );
 
   void         recomputeBoundingBox();
-  void         center( Box box, float fBoxSize );
-  virtual void scale( Box box, float fBoxSize );
   virtual void sortVertex(const Camera& cam);
   /**
    * \brief allocate the current object.
@@ -92,9 +96,9 @@ class ObjectPointcloud : public Object {
     } else {
       m_pPoints[m_iIndex] = point;
       if ( m_bAlpha ) {
-        m_pColors4[m_iIndex] = color / 255.f;
+        m_pColors4[m_iIndex] = toColor8Bit( color );
       } else {
-        m_pColors3[m_iIndex] = glm::vec3( color ) / 255.f;
+        m_pColors3[m_iIndex] = toColor8Bit( Color3( color ) );
       }
       if ( m_bNormal ) { m_pNormals[m_iIndex] = normal; }
       if ( m_bType ) { m_pTypes[m_iIndex] = type; }
@@ -106,40 +110,66 @@ class ObjectPointcloud : public Object {
   //! Get the pointer to the stored data. \return Pointer to the stored data.
   inline size_t             getNumPoints() const { return m_iNumPoints; }
   inline Point*             getPoints() { return m_pPoints.data(); };
-  inline std::vector<Point> getVectorPoints() { return m_pPoints; };
+  inline PointVector<Point> getVectorPoints() { return m_pPoints; };
   inline Point&             getPoints( size_t iIndex ) { return m_pPoints[iIndex]; };
-  inline Color3&            getColors3( size_t iIndex ) {
+  inline Color3u8&          getColors3u8( size_t iIndex ) {
     if ( !m_bAlpha ) { return m_pColors3[iIndex]; }
-    return *( reinterpret_cast<Color3*>( &( m_pColors4[iIndex] ) ) );
+    return *( reinterpret_cast<Color3u8*>( &( m_pColors4[iIndex] ) ) );
   };
+  inline Color3 getColors3( size_t iIndex ) { return Color3( getColors3u8( iIndex ) ) / 255.f; }
   inline Color4 getColors4( size_t iIndex ) {
-    if ( m_bAlpha ) { return m_pColors4[iIndex]; }
-    Color4 convert;
-    convert[0] = m_pColors3[iIndex][0];
-    convert[1] = m_pColors3[iIndex][1];
-    convert[2] = m_pColors3[iIndex][2];
-    convert[3] = 1.f;
-    return convert;
+    if ( m_bAlpha ) { return Color4( m_pColors4[iIndex] ) / 255.f; }
+    return Color4( Color3( m_pColors3[iIndex] ) / 255.f, 1.f );
   }
-  inline void*    getColors() { return ( m_bAlpha ? (void*)m_pColors4.data() : (void*)m_pColors3.data() ); };
-  inline Color3*  getColors3() { return m_pColors3.data(); };
-  inline Color4*  getColors4() { return m_pColors4.data(); };
+  inline void*     getColors() { return ( m_bAlpha ? (void*)m_pColors4.data() : (void*)m_pColors3.data() ); };
+  inline Color3u8* getColors3() { return m_pColors3.data(); };
+  inline Color4u8* getColors4() { return m_pColors4.data(); };
   inline Normal*  getNormals() { return m_pNormals.data(); };
   inline uint8_t* getTypes() { return m_pTypes.data(); };
 
+  //! Set the optional attributes read by the next reads (combination of PointAttribute).
+  inline void    setAttributes( uint8_t iAttributes ) { m_iAttributes = iAttributes; }
+  /**
+   * \brief set the quantization of the positions written in the binary cache files.
+   * \param iBits Bits per coordinate of the positions on a regular grid of the bounding box, 0 for lossless files.
+   */
+  inline void    setQuantization( int iBits ) { m_iQuantization = static_cast<uint8_t>( iBits ); }
+  //! Get the attributes of the source that have not been read. \return Combination of PointAttribute.
+  inline uint8_t getSkippedAttributes() { return m_iSkippedAttributes; }
+  //! Get the number of colors per point of the rig cameras. \return 0 if the multi-colors have not been read.
+  inline size_t  getNumMultiColors() { return m_bMultiColor ? m_eRigParameters.getCount() : 0; }
+  /**
+   * \brief move the skipped attributes from a read of the same frame with more attributes.
+   * \param eObject Same frame read with the same duplicate points mode and order.
+   * \return False if the frames do not have the same number of points.
+   */
+  bool copyAttributes( ObjectPointcloud& eObject );
+  //! Get the hash of the points and of the attributes that have been read, the identical frames have the same hash.
+  uint64_t getContentHash();
+  //! True if the frames have the same points and the same attributes that have been read.
+  bool     isSameContent( ObjectPointcloud& eObject );
+
   //! Get the alpha boolean. \return Boolean indicate that the current object have alpha component.
   inline bool getAlpha() { return m_bAlpha; };
   //! Get the normal boolean. \return Boolean indicate that the current object have normal components.
   inline bool getNormal() { return m_bNormal; };
 
+  //! Get the type boolean. \return Boolean indicate that the current object have type component.
+  inline bool getHasType() { return m_bType; };
+
   //! Get the number of duplicate points. \return Number of duplicate points.
   inline int getNumDuplicate() { return m_iNumDuplicate; };
+
+  //! Get the offset of the vertex data in the PLY file. \return Offset in bytes, 0 if read from a binary file.
+  inline uint64_t getDataOffset() { return m_iDataOffset; };
+  //! Get the format of the PLY file. \return 0: unknown or binary file, 1: ascii, 2: binary_little_endian.
+  inline uint8_t getFileFormat() { return m_iFileFormat; };
   void       setBox( float fXMin, float fXMax, float fYMin, float fYMax, float fZMin, float fZMax );
 
   Vec3                 getBoundingBoxCenterPosition() { return m_eBox.center(); }
-  std::vector<Color3>& getMultiColors3() { return m_pMultiColors3; };
-  inline void          setMultiColors3( size_t index, size_t color, Color3 eColor ) {
-    m_pMultiColors3[index * m_eRigParameters.getCount() + color] = eColor / 255.f;
+  PointVector<Color3u8>& getMultiColors3() { return m_pMultiColors3; };
+  inline void            setMultiColors3( size_t index, size_t color, Color3 eColor ) {
+    m_pMultiColors3[index * m_eRigParameters.getCount() + color] = toColor8Bit( eColor );
   }
   RigParameters&     getRigParameters() { return m_eRigParameters; }
   std::vector<float> computeWeigth();
@@ -157,13 +187,50 @@ class ObjectPointcloud : public Object {
     m_pMultiColors3.clear();
   }
 
+  //! Free the memory of the stored points, the bounding box is kept.
+  inline void release() {
+    PointVector<Point>().swap( m_pPoints );
+    PointVector<Color3u8>().swap( m_pColors3 );
+    PointVector<Color4u8>().swap( m_pColors4 );
+    PointVector<Normal>().swap( m_pNormals );
+    PointVector<uint8_t>().swap( m_pTypes );
+    PointVector<Color3u8>().swap( m_pMultiColors3 );
+    m_iNumPoints  = 0;
+    m_iIndex      = 0;
+    m_bMultiColor = false;
+  }
+
+  //! Get the memory used by the stored points. \return Size in bytes.
+  inline size_t getMemorySize() {
+    return m_pPoints.capacity() * sizeof( Point ) + m_pColors3.capacity() * sizeof( Color3u8 ) +
+           m_pColors4.capacity() * sizeof( Color4u8 ) + m_pNormals.capacity() * sizeof( Normal ) +
+           m_pTypes.capacity() * sizeof( uint8_t ) + m_pMultiColors3.capacity() * sizeof( Color3u8 );
+  }
+
 
 
   std::string getInformation();
   void        removeDuplicatePoints( int iDropDups );
-  bool        readBinary( const std::string& eString, int iFrameIndex );
-  void        writeBinary( const std::string& eString );
+  //! Reorder all the per-point arrays in Morton order of the positions quantized in the bounding box.
+  void        sortMortonOrder();
+  bool        readBinary( const std::string& eString, int iFrameIndex, int iDropDups );
+  void        writeBinary( const std::string& eString, int iDropDups );
+  bool        readContainer( const SequenceContainer& eContainer, size_t iFrame );
+  bool        decodeBinary( const uint8_t* pData, size_t iSize, int iFrameIndex, int iDropDups );
+  void        encodeBinary( std::vector<uint8_t>& pBuffer, int iDropDups );
+  //! Compress the points in a buffer kept in memory, the frame can be released and restored by decompress().
+  void        compress( std::vector<uint8_t>& pBuffer );
+  bool        decompress( const std::vector<uint8_t>& pBuffer );
+  bool        readAscii( const char* pData, size_t iSize, int iOrder, const std::vector<int>& pOrder );
+  bool        readBinaryLittleEndian( const uint8_t*                   pData,
+                                      size_t                           iSize,
+                                      size_t                           iStride,
+                                      const std::vector<int>&          pIndex,
+                                      const std::vector<CastFunction>& pCast,
+                                      size_t                           iFirstPoint,
+                                      size_t                           iNumPoints );
   void        createBinaryDirectory( const std::string& eString );
+  void        dropAttributes();
 
   // Must return the number of data points
   inline size_t kdtree_get_point_count() const { return m_iNumPoints; }
@@ -192,9 +259,10 @@ class ObjectPointcloud : public Object {
   const std::string& getProgramName() { return m_ePrograms[m_iProgramIndex].getName(); }
 
  private:
-  void computeDistance( std::vector<Color3>& eColors );
-  void computeDuplicate( std::vector<Color3>& eColors );
-  void colorBasedType( std::vector<Color3>& eColors );
+  void  computeDistance( std::vector<Color3>& eColors );
+  float getSearchRadius();
+  void  computeDuplicate( std::vector<Color3>& eColors );
+  void  colorBasedType( std::vector<Color3>& eColors );
  
   static std::vector<Program> m_ePrograms;
   static int32_t              m_iProgramIndex;
@@ -203,20 +271,28 @@ class ObjectPointcloud : public Object {
   GLuint                      m_uiCBO;
   GLuint                      m_uiMCBO;
   GLuint                      m_uiIBO;
-  std::vector<Point>          m_pPoints;
-  std::vector<Color3>         m_pColors3;
-  std::vector<Color4>         m_pColors4;
-  std::vector<Normal>         m_pNormals;
-  std::vector<uint8_t>        m_pTypes;
+  PointVector<Point>          m_pPoints;
+  PointVector<Color3u8>       m_pColors3;
+  PointVector<Color4u8>       m_pColors4;
+  PointVector<Normal>         m_pNormals;
+  PointVector<uint8_t>        m_pTypes;
   int                         m_iIndex  = 0;
   bool                        m_bAlpha  = false;
   bool                        m_bNormal = false;
   bool                        m_bType   = false;
   bool                        m_bSort   = true;
-  std::vector<Color3>         m_pMultiColors3;
+  PointVector<Color3u8>       m_pMultiColors3;
   RigParameters               m_eRigParameters;
-  int                         m_iNumPoints    = 0;
-  int                         m_iNumDuplicate = 0;
+  int                         m_iNumPoints         = 0;
+  int                         m_iNumDuplicate      = 0;
+  uint64_t                    m_iDataOffset        = 0;
+  uint8_t                     m_iFileFormat        = 0;
+  bool                        m_bMortonOrder       = false;
+  bool                        m_bMultiColor        = false;
+  uint8_t                     m_iAttributes        = ATTRIBUTE_ALL;
+  uint8_t                     m_iSkippedAttributes = 0;
+  uint8_t                     m_iQuantization      = 0;
+  uint8_t                     m_iPositionBits      = 0;  // quantization of the binary file read
 };
 
 #endif  // _OBJECT_PLY_RENDERER_APP_H_
@@ -23,6 +23,8 @@ class RendererParameters {
   inline std::string getRgbFile() const { return m_pRgbFile; }
   inline std::string getCameraPathFile() const { return m_pCameraPathFile; }
   inline std::string getViewpointFile() const { return m_pViewpointFile; }
+  inline std::string getContainerFile() const { return m_pContainerFile; }
+  inline std::string getCacheDir() const { return m_pCacheDir; }
   inline int         getFrameNumber() const { return m_iFrameNumber; }
   inline int         getFrameIndex() const { return m_iFrameIndex; }
   inline int         getAlign() const { return m_iAlign; }
@@ -39,6 +41,11 @@ class RendererParameters {
   inline int         getRotate() const { return m_iRotate; }
   inline int         getDropDups() const { return m_iDropDups; }
   inline int         getCameraPathIndex() const { return m_iCameraPathIndex; }
+  inline int         getMemoryBudget() const { return m_iMemoryBudget; }
+  inline int         getIoPrefetch() const { return m_iIoPrefetch; }
+  inline int         getCompressedBudget() const { return m_iCompressedBudget; }
+  inline int         getCacheSize() const { return m_iCacheSize; }
+  inline int         getQuantization() const { return m_iQuantization; }
   inline bool        getCenter() const { return m_bCenter; }
   inline bool        getPause() const { return !m_bPlay; }
   inline bool        getPlayBackward() const { return m_bPlayBackward; }
@@ -47,6 +54,7 @@ class RendererParameters {
   inline bool        getOrthographic() const { return m_bOrthographic; }
   inline bool        getSynchronize() const { return m_bSynchronize; }
   inline bool        getBinaryFile() const { return m_bCreateBinaryFiles; }
+  inline bool        getMortonOrder() const { return m_bMortonOrder; }
   inline bool        getDepthMap() const { return m_bDepthMap; }
   inline bool        getFloor() const { return m_bFloor; }
   inline std::string getScenePath() const { return m_pScenePath; }
@@ -61,6 +69,8 @@ class RendererParameters {
   inline bool        getVisible() const { return m_bVisible; }
   inline bool        getLighting() const { return m_bLighting; }
   inline bool        getSoftwareRenderer() const { return m_bSoftwareRenderer; }
+  inline int         getReorderDepth() const { return m_iReorderDepth; }
+  inline bool        getDeferredShading() const { return m_bDeferredShading; }
 
  private:
   std::string m_pFile;
@@ -71,6 +81,8 @@ class RendererParameters {
   std::string m_pCameraPathFile;
   std::string m_pViewpointFile;
   std::string m_pScenePath;
+  std::string m_pContainerFile;
+  std::string m_pCacheDir;
   int         m_iFrameNumber;
   int         m_iFrameIndex;
   int         m_iAlign;
@@ -86,10 +98,16 @@ class RendererParameters {
   int         m_iRotate;
   int         m_iDropDups;
   int         m_iCameraPathIndex;
+  int         m_iMemoryBudget;
+  int         m_iIoPrefetch;
+  int         m_iCompressedBudget;
+  int         m_iCacheSize;
+  int         m_iQuantization;
   bool        m_bCenter;
   bool        m_bPlay;
   bool        m_bPlayBackward;
   bool        m_bCreateBinaryFiles;
+  bool        m_bMortonOrder;
   bool        m_bSpline;
   bool        m_bOverlay;
   bool        m_bSynchronize;
@@ -99,6 +117,8 @@ class RendererParameters {
   bool        m_bOrthographic;
   bool        m_bLighting;
   bool        m_bSoftwareRenderer;
+  int         m_iReorderDepth;
+  bool        m_bDeferredShading;
   float       m_fPointSize;
   int         m_iBlendMode;
   float       m_fAlphaFalloff;
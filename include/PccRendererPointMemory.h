@@ -0,0 +1,99 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _POINT_MEMORY_RENDERER_APP_H_
+#define _POINT_MEMORY_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+#include <atomic>
+
+/*! \class %PointMemory
+ * \brief %PointMemory class.
+ *
+ *  Memory of the per-point arrays of the point clouds. The arrays of at least 2 MB are mapped on 2 MB boundaries and
+ *  advised as transparent huge pages (madvise( MADV_HUGEPAGE )): the threads that walk the points of a frame use a few
+ *  TLB entries. On the NUMA machines, the frames of a sequence are spread by contiguous ranges over the nodes, the
+ *  arrays of a frame are bound to the node of its range (mbind) and the software renderer renders the frames by the
+ *  threads of their node. On a single node machine only the huge pages are used.
+ */
+class PointMemory {
+ public:
+  static PointMemory& getInstance();
+
+  void* allocate( size_t iSize );
+  void  deallocate( void* pData, size_t iSize );
+
+  inline int getNumNodes() const { return m_iNumNodes; }
+  //! NUMA node of the cpu running the calling thread.
+  int getCurrentNode() const;
+  //! NUMA node of a frame: the frames are spread by contiguous ranges over the nodes.
+  inline int getFrameNode( int iFrame, int iNumFrames ) const {
+    return iNumFrames > 0 && m_iNumNodes > 1
+               ? m_pNodes[static_cast<size_t>( static_cast<int64_t>( iFrame ) * m_iNumNodes / iNumFrames )]
+               : 0;
+  }
+
+  //! Node of the arrays allocated by the calling thread, -1: the pages are placed by the first thread that writes them.
+  static int  getPreferredNode();
+  static void setPreferredNode( int iNode );
+
+  //! Sample the nodes of the pages of an array read by the calling thread, for the NUMA local ratio of printStats().
+  void recordAccess( const void* pData, size_t iSize );
+  void printStats();
+
+ private:
+  PointMemory();
+  ~PointMemory();
+  PointMemory( const PointMemory& ) = delete;
+  PointMemory& operator=( const PointMemory& ) = delete;
+
+  int                   m_iNumNodes = 1;
+  int                   m_iMaxNode  = 0;
+  std::vector<int>      m_pNodes;  // ids of the online nodes with cpus
+  std::vector<int>      m_pCpuNode;
+  std::atomic<uint64_t> m_iAllocatedSize;
+  std::atomic<uint64_t> m_iHugePageSize;
+  std::atomic<uint64_t> m_iLocalPages;
+  std::atomic<uint64_t> m_iRemotePages;
+};
+
+/*! \class %PreferredNode
+ * \brief %PreferredNode class.
+ *
+ *  Scope in which the point arrays allocated by the calling thread are bound to a NUMA node.
+ */
+class PreferredNode {
+ public:
+  PreferredNode( int iNode ) : m_iPrevious( PointMemory::getPreferredNode() ) { PointMemory::setPreferredNode( iNode ); }
+  ~PreferredNode() { PointMemory::setPreferredNode( m_iPrevious ); }
+
+ private:
+  int m_iPrevious;
+};
+
+//! Allocator of the per-point arrays.
+template <typename T>
+class PointAllocator {
+ public:
+  typedef T value_type;
+  PointAllocator() = default;
+  template <typename U>
+  PointAllocator( const PointAllocator<U>& ) {}
+  T*   allocate( size_t iCount ) { return static_cast<T*>( PointMemory::getInstance().allocate( iCount * sizeof( T ) ) ); }
+  void deallocate( T* pData, size_t iCount ) { PointMemory::getInstance().deallocate( pData, iCount * sizeof( T ) ); }
+  template <typename U>
+  bool operator==( const PointAllocator<U>& ) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=( const PointAllocator<U>& ) const {
+    return false;
+  }
+};
+
+template <typename T>
+using PointVector = std::vector<T, PointAllocator<T> >;
+
+#endif  //~_POINT_MEMORY_RENDERER_APP_H_
@@ -0,0 +1,85 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _PREFETCHER_RENDERER_APP_H_
+#define _PREFETCHER_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef USE_IO_URING
+#include <liburing.h>
+#endif
+
+/*! \class %Prefetcher
+ * \brief %Prefetcher class.
+ *
+ *  Asynchronous reads of the next frames of a streamed sequence. A background thread reads the requested file ranges
+ *  in the page cache while the current frame is decoded, so the memory mapped readers find the data resident. The
+ *  reads are submitted in batches with io_uring when the renderer is built with liburing (USE_IO_URING) and the
+ *  kernel supports it, otherwise the thread advises the kernel with posix_fadvise( WILLNEED ) and reads the blocks.
+ */
+class Prefetcher {
+ public:
+  //! Range of a file to read, m_iSize = 0 to read the file until its end.
+  struct Request {
+    std::string m_sFilename;
+    uint64_t    m_iOffset = 0;
+    uint64_t    m_iSize   = 0;
+  };
+
+  static Prefetcher& getInstance();
+
+  /**
+   * \brief replace the pending requests by the next frames to read.
+   * \param pRequests File ranges in read order, the request in flight is completed.
+   */
+  void prefetch( const std::vector<Request>& pRequests );
+
+  /**
+   * \brief called by the readers before reading a file range: waits for the end of its read if it is in flight. A
+   * pending request of the range is canceled, the reader reads the data itself.
+   */
+  void wait( const std::string& sFilename, uint64_t iOffset = 0 );
+
+  //! Print the bytes read by the prefetcher, the peak of the bytes in flight and the time spent by the readers waiting
+  //! for the requests in flight.
+  void printStats();
+
+ private:
+  Prefetcher();
+  ~Prefetcher();
+  Prefetcher( const Prefetcher& ) = delete;
+  Prefetcher& operator=( const Prefetcher& ) = delete;
+  void        process();
+  void        read( const Request& eRequest );
+  void        addBytesInFlight( uint64_t iSize );
+#ifndef WIN32
+  void readBlocks( int iFile, uint64_t iBegin, uint64_t iEnd );
+#endif
+
+  std::deque<Request>     m_eQueue;
+  Request                 m_eCurrent;
+  bool                    m_bReading = false;
+  bool                    m_bStop    = false;
+  std::vector<uint8_t>    m_pBuffer;
+  std::atomic<uint64_t>   m_iBytesRead{0};
+  uint64_t                m_iBytesInFlight = 0;
+  std::atomic<uint64_t>   m_iPeakBytesInFlight{0};
+  std::atomic<double>     m_fStallTime{0.};
+  std::thread             m_eThread;
+  std::mutex              m_eMutex;
+  std::condition_variable m_eCondition;
+#ifdef USE_IO_URING
+  struct io_uring m_eRing;
+  bool            m_bRing = false;
+#endif
+};
+
+#endif  //~_PREFETCHER_RENDERER_APP_H_
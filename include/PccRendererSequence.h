@@ -7,6 +7,13 @@
 
 #include "PccRendererDef.h"
 #include "PccRendererObject.h"
+#include "PccRendererSequenceIndex.h"
+#include "PccRendererSequenceContainer.h"
+#include "PccRendererPrefetcher.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 /*! \class %Sequence class
  * \brief %Sequence class.
@@ -22,7 +29,7 @@ class Sequence {
   Object&                   getObject();
   Object&                   getObject( int i );
   inline Box&               getBox() { return m_eBox; }
-  const std::string&        getFilename();
+  std::string               getFilename();
   std::vector<std::string>& getTypeName() { return m_pTypeName; }
   ObjectType                getObjectType() { return m_eObject[0]->getType(); }
   void                      loadProgram() { m_eObject[0]->loadProgram(); }
@@ -36,17 +43,56 @@ class Sequence {
   bool                      getHaveSource() { return !m_eObjectSrc.empty(); }
   bool                      getDisplaySource() { return m_bDisplaySource; }
   void                      setDropDups( int32_t iDropDups ) { m_iDropDups = iDropDups; }
+  void                      setMortonOrder( bool bMortonOrder ) { m_bMortonOrder = bMortonOrder; }
+  void                      setQuantization( int iQuantization ) { m_iQuantization = iQuantization; }
+  void                      setAttributes( uint8_t iAttributes ) { m_iAttributes = iAttributes; }
   void                      setPlayBackward( bool bPlayBackward ) { m_bPlayBackward = bPlayBackward; }
-  void                      setFrameIndex( int32_t iFrameIndex ) { m_iFrameIndex = iFrameIndex; }
+  void                      setFrameIndex( int32_t iFrameIndex );
+  void                      setMemoryBudget( size_t iMemoryBudget ) { m_iMemoryBudget = iMemoryBudget; }
+  void                      setIoPrefetch( int iIoPrefetch ) { m_iIoPrefetch = iIoPrefetch; }
+  void                      setCompressedBudget( size_t iCompressedBudget ) { m_iCompressedBudget = iCompressedBudget; }
+  bool                      getStreaming() { return m_iMemoryBudget > 0; }
   void                      load();
-  void                      unload();
+  void                      unload( bool bKeepCurrent = false );
   bool                      check();
 
-  void readDirectory( const std::string& sDir, int iFrameNumber, bool eBinary, bool bSource = false );
-  void readFile( const std::string& sFile, int iFrameIndex, int iFrameNumber, bool eBinary, bool bSource = false );
+  /**
+   * \brief read the optional attributes of the point clouds that have been skipped by the previous reads.
+   * \param iAttributes Attributes required by the render mode (combination of PointAttribute).
+   */
+  void requestAttributes( uint8_t iAttributes );
+
+  /**
+   * \brief get an object and keep it in memory until releaseObject() is called (streaming mode).
+   * \param iIndex Frame index in playback order.
+   */
+  Object& acquireObject( int iIndex );
+  void    releaseObject( int iIndex );
+  //! NUMA node of the points of a frame given in playback order, see %PointMemory.
+  int     getFrameNode( int iIndex );
+  void    startPrefetch();
+  void    stopPrefetch();
+
+  /**
+   * \brief read the frames of the sequence and of the optional source sequence.
+   *
+   * The frames are read by OpenMP tasks: called in a parallel region, they are balanced with the tasks of the other
+   * sequences read in the same region.
+   * \param sFile, sDir Frames of the sequence, given by a file pattern and/or a directory.
+   * \param sFileSrc, sDirSrc Frames of the source sequence.
+   */
+  void read( const std::string& sFile,
+             const std::string& sDir,
+             const std::string& sFileSrc,
+             const std::string& sDirSrc,
+             int                iFrameIndex,
+             int                iFrameNumber,
+             bool               bBinary );
+  bool writeContainer( const std::string& sFilename );
   void normalize( int32_t iScaleMode, bool bCenter );
   void printBoundingBox( std::string string, bool bAll = false );
   void recomputeBoundingBox();
+  void updateBoundingBox();
   int  getNumFrames() { return (int)( m_bPlayBackward ? 2 * (int)m_eObject.size() - 1 : (int)m_eObject.size() ); }
   void setDisplaySource( bool bDisplaySource ) { m_bDisplaySource = bDisplaySource; }
   void setBoxSize( float fBoxSize ) { m_fBoxSize = fBoxSize == 0 ? m_eBox.getMaxSize() : fBoxSize; }
@@ -65,10 +111,44 @@ class Sequence {
  private:
   void add( std::shared_ptr<Object> pObject, bool bSource );
   void getFileInDirector( std::string sDirector, std::string sExtension, std::vector<std::string>& eFileLists );
+  void readDirectory( const std::string& sDir, int iFrameNumber, bool eBinary, bool bSource );
   void readDirectory( std::string pDirector, std::string pExtension, int iFrameNumber, bool bBinary, bool bSource );
+  void readFile( const std::string& sFile, int iFrameIndex, int iFrameNumber, bool eBinary, bool bSource );
+  void addTypeName( SequenceIndex& eIndex, const std::vector<std::string>& pTypeName );
+  void shareFrame( std::vector<std::shared_ptr<Object> >& eObject, int iIndex );
+  bool readIndex( SequenceIndex&                  eIndex,
+                  const std::string&              sIndexName,
+                  const std::vector<std::string>& pFilenames,
+                  bool                            bSource );
+  int  getObjectIndex( int iIndex );
+  void waitObject( int iObjectIndex, std::unique_lock<std::mutex>& eLock );
+  void loadObject( int iObjectIndex, std::vector<std::string>& pTypeName );
+  void prefetch();
+
+  //! Information required to reload a frame in streaming mode.
+  struct FrameSource {
+    std::string                        m_sFilename;
+    int                                m_iFrameIndex = -1;  // frame of the container if m_pContainer is set
+    bool                               m_bBinary     = false;
+    size_t                             m_iSize       = 0;
+    std::shared_ptr<SequenceContainer> m_pContainer;
+
+    //! Index of the frame in the sequence, -1 for the frames of a directory.
+    int getFrameIndex() const {
+      return m_pContainer ? m_pContainer->getFrame( m_iFrameIndex ).m_iFrameIndex : m_iFrameIndex;
+    }
+  };
+  void readContainer( const std::string& sFile, int iFrameIndex, int iFrameNumber, bool bSource );
+  bool readFrame( ObjectPointcloud& eObject, const FrameSource& eSource, std::vector<std::string>& pTypeName );
+  void addRequests( int iObjectIndex, std::vector<Prefetcher::Request>& pRequests );
+  void storeCompressed( ObjectPointcloud& eObject, int iObjectIndex, bool bSource );
+  void clearCompressed();
 
  protected:
   int                                   m_iDropDups      = 2;
+  bool                                  m_bMortonOrder   = false;
+  int                                   m_iQuantization  = 0;
+  uint8_t                               m_iAttributes    = ATTRIBUTE_ALL;
   int                                   m_iFrameIndex    = 0;
   bool                                  m_bPlayBackward  = false;
   bool                                  m_bDisplaySource = false;
@@ -78,6 +158,34 @@ class Sequence {
   std::vector<std::shared_ptr<Object> > m_eObjectSrc;
   std::vector<std::string>              m_pTypeName;
   Box                                   m_eBox;
+
+  // Identical frames read from different files share the same object, registered by the hash of their content while
+  // the sequence is read.
+  bool                                                      m_bShareFrames = false;
+  std::multimap<uint64_t, std::shared_ptr<ObjectPointcloud> > m_pSharedFrames;
+
+  // Streaming mode: only the frames that fit in the memory budget are resident.
+  size_t                   m_iMemoryBudget = 0;
+  int                      m_iIoPrefetch   = 0;
+  int                      m_iCursor       = 0;
+  bool                     m_bStopPrefetch = false;
+  std::vector<FrameSource> m_pFrameSource;
+  std::vector<FrameSource> m_pFrameSourceSrc;
+  std::vector<size_t>      m_pFrameSize;
+  std::vector<uint8_t>     m_pResident;
+  std::vector<int>         m_pPinned;
+  std::thread              m_eThread;
+  std::mutex               m_eMutex;
+  std::condition_variable  m_eCursorChanged;
+  std::condition_variable  m_eObjectLoaded;
+
+  // Streaming mode: the frames evicted are kept compressed in memory within their own budget, they are decompressed by
+  // the prefetch thread instead of being read again from the files.
+  size_t                            m_iCompressedBudget = 0;
+  size_t                            m_iCompressedSize   = 0;
+  bool                              m_bCompressedFull   = false;
+  std::vector<std::vector<uint8_t>> m_pCompressed;
+  std::vector<std::vector<uint8_t>> m_pCompressedSrc;
 };
 
 #endif  // _SEQUENCE_RENDERER_APP_H_
@@ -0,0 +1,74 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _SEQUENCE_CONTAINER_RENDERER_APP_H_
+#define _SEQUENCE_CONTAINER_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+#include "PccRendererObject.h"
+#include "PccRendererMemoryMap.h"
+
+class ObjectPointcloud;
+
+/*! \class %SequenceContainer
+ * \brief %SequenceContainer class.
+ *
+ *  Single file (.pcs) that stores all the frames of a point cloud sequence: a header with the sequence bounding box,
+ *  the frames in the binary cache format aligned on 64 bytes, a frame offset table and the names of the point types
+ *  at the end of the file. The
+ *  file is opened with one read-only mapping, the renderer processes that read the same container share one copy in
+ *  the page cache.
+ */
+class SequenceContainer {
+ public:
+  struct Frame {
+    uint64_t m_iOffset;
+    uint64_t m_iSize;
+    uint64_t m_iMemorySize;  // memory used by the frame once decoded
+    int32_t  m_iFrameIndex;
+    uint32_t m_iNumPoints;
+    float    m_pBox[6];
+    uint8_t  m_pReserved[8];
+  };
+
+  SequenceContainer();
+  ~SequenceContainer();
+
+  //! Map the container in memory. \return True if the file is a valid container.
+  bool open( const std::string& sFilename );
+
+  /**
+   * \brief create a new container, the frames are appended by add() and the file is completed by finish().
+   * \param sFilename Name of the container.
+   * \param iDropDups Duplicate points mode used to read the frames.
+   */
+  bool create( const std::string& sFilename, int iDropDups );
+  //! Append a frame, iFrameIndex is its index in the sequence or -1 to use its position in the container.
+  bool add( ObjectPointcloud& eObject, int iFrameIndex );
+  bool finish( Box eBox, const std::vector<std::string>& pTypeName );
+
+  inline const std::string& getFilename() const { return m_sFilename; }
+  inline size_t             getNumFrames() const { return m_pFrames.size(); }
+  inline const Frame&       getFrame( size_t iFrame ) const { return m_pFrames[iFrame]; }
+  inline const uint8_t*     getFrameData( size_t iFrame ) const {
+    return m_eMemoryMap.data() + m_pFrames[iFrame].m_iOffset;
+  }
+  inline Box                getFrameBox( size_t iFrame ) const {
+    const float* pBox = m_pFrames[iFrame].m_pBox;
+    return Box( Vec3( pBox[0], pBox[1], pBox[2] ), Vec3( pBox[3], pBox[4], pBox[5] ) );
+  }
+  inline int                             getDropDups() const { return m_iDropDups; }
+  inline const std::vector<std::string>& getTypeName() const { return m_pTypeName; }
+
+ private:
+  std::string              m_sFilename;
+  int                      m_iDropDups = 0;
+  MemoryMap                m_eMemoryMap;
+  std::vector<Frame>       m_pFrames;
+  std::vector<std::string> m_pTypeName;
+  std::ofstream            m_eOutput;
+  uint64_t                 m_iOutputSize = 0;
+};
+
+#endif  //~_SEQUENCE_CONTAINER_RENDERER_APP_H_
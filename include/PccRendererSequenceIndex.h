@@ -0,0 +1,64 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _SEQUENCE_INDEX_RENDERER_APP_H_
+#define _SEQUENCE_INDEX_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+#include "PccRendererObject.h"
+
+class ObjectPointcloud;
+
+/*! \class %SequenceIndex
+ * \brief %SequenceIndex class.
+ *
+ *  Sidecar file of a directory or of a file pattern that stores, for each frame, the number of points, the attribute
+ *  layout, the bounding box, the size and modification time of the file and the offset of the vertex data. A frame
+ *  record is only used if the size and the modification time of the file are unchanged.
+ */
+class SequenceIndex {
+ public:
+  struct Frame {
+    std::string m_sFilename;
+    uint64_t    m_iFileSize       = 0;
+    int64_t     m_iFileTime       = 0;
+    uint64_t    m_iDataOffset     = 0;  // 0 if the frame has been read from a binary file
+    uint32_t    m_iNumPoints      = 0;  // after the removal of the duplicate points
+    uint32_t    m_iNumDuplicate   = 0;
+    uint32_t    m_iNumMultiColors = 0;
+    uint8_t     m_iFormat         = 0;  // 0: unknown, 1: ascii, 2: binary_little_endian
+    uint8_t     m_bAlpha          = 0;
+    uint8_t     m_bNormal         = 0;
+    uint8_t     m_bType           = 0;
+    Box         m_eBox;
+
+    /**
+     * \brief get the memory used by the points of the frame once decoded.
+     * \param iAttributes Optional attributes that are read (combination of PointAttribute).
+     * \return Size in bytes.
+     */
+    size_t getMemorySize( uint8_t iAttributes ) const;
+  };
+
+  SequenceIndex();
+  ~SequenceIndex();
+
+  bool read( const std::string& sFilename, int iDropDups );
+  bool write( const std::string& sFilename, int iDropDups );
+  void add( ObjectPointcloud& eObject, const std::string& sFilename );
+
+  /**
+   * \brief get the record of a frame.
+   * \param sFilename Name of the PLY file of the frame.
+   * \return Pointer to the record or nullptr if the frame is not indexed or if the file has been modified.
+   */
+  const Frame*              find( const std::string& sFilename ) const;
+  std::vector<std::string>& getTypeName() { return m_pTypeName; }
+
+ private:
+  std::map<std::string, Frame> m_eFrames;
+  std::vector<std::string>     m_pTypeName;
+};
+
+#endif  //~_SEQUENCE_INDEX_RENDERER_APP_H_
@@ -13,8 +13,17 @@ class ObjectMesh;
 class ObjectPointcloud;
 class Mesh;
 class Box;
-struct ShaderMesh;
 
+/*! \class %SoftwareRenderer
+ * \brief %SoftwareRenderer class.
+ *
+ *  Rasterization of the objects in an image without OpenGL. The primitives are projected and binned in screen tiles
+ *  by parallel tasks, then the tiles are rasterized by parallel tasks: each tile owns the pixels of its rectangle in
+ *  the image and in the depth buffer, and draws its primitives in their submission order, so the result does not
+ *  depend on the number of threads. Called in a parallel region, the idle threads steal the tasks of the tiles.
+ *  In deferred shading mode, the meshes are first rasterized in a visibility buffer (mesh, face and barycentric
+ *  coordinates of the visible surface), then each visible pixel is shaded once, tile by tile and mesh by mesh.
+ */
 class SoftwareRenderer {
  public:
   SoftwareRenderer( Image& image, Mat4& eMatMod, Mat4& eMatPro, bool bLighting );
@@ -25,9 +34,20 @@ class SoftwareRenderer {
   void drawObject( Object& eObject );
   void drawObject( ObjectMesh& eObject );
   void drawObject( ObjectPointcloud& eObject );
-  void drawMesh( Mesh& eMesh, ShaderMesh& shader );
+  //! Draw the mesh with iMesh >= 0 in the visibility buffer, else shade its pixels.
+  template <typename Shader>
+  void drawMesh( Mesh& eMesh, const Shader& shader, int iMesh = -1 );
+  inline void setDeferredShading( bool bDeferredShading ) { m_bDeferredShading = bDeferredShading; }
 
  private:
+  //! Surface visible in a pixel, the third barycentric coordinate is 1 - the two others.
+  struct Visibility {
+    int32_t m_iMesh;
+    int32_t m_iFace;
+    float   m_fCoord[2];
+  };
+  //! Set the model matrix of the next objects: the normalization of the sequence or the identity.
+  void setModel( const Mat4& eModel );
   inline Vec2 projToScreen( const Vec4& proj ) const {
     return Vec2( ( 0.5 * ( proj[0] / proj[3] ) + 0.5 ) * m_eViewport[2] + m_eViewport[0],
                  ( 0.5 * ( proj[1] / proj[3] ) + 0.5 ) * m_eViewport[3] + m_eViewport[1] );
@@ -59,6 +79,12 @@ class SoftwareRenderer {
         m_eMax[i] = std::min( std::max( m_eMax[i], (int)( screen[i] + delta ) ), m_eSize[i] );
       }
     }
+    //! Restrict the area to the pixels of a tile.
+    inline void clip( const Vec2i& eMin, const Vec2i& eMax ) {
+      m_eMin = glm::max( m_eMin, eMin );
+      m_eMax = glm::min( m_eMax, eMax );
+    }
+    inline bool         empty() const { return m_eMin.x > m_eMax.x || m_eMin.y > m_eMax.y; }
     inline const Vec2i& min() const { return m_eMin; }
     inline const Vec2i& max() const { return m_eMax; }
 
@@ -69,13 +95,34 @@ class SoftwareRenderer {
   };
   friend class ScreenArea;
 
+  //! Primitives of each tile, binned by chunks of primitives: pBins[chunk][tile] lists the primitives in order.
+  typedef std::vector<std::vector<std::vector<int> > > Bins;
+  void getTile( int iTile, Vec2i& eMin, Vec2i& eMax ) const;
+  template <typename Function>
+  void forEachTile( const ScreenArea& area, const Function& pFunction ) const;
+  //! Call pFunction( shader ) with the shader of a mesh.
+  template <typename Function>
+  void forShader( Mesh& eMesh, const Function& pFunction );
+  //! Rasterize a projected face in the pixels [eMin;eMax] of a tile, pOutput( x, y, coord ) outputs the pixels that
+  //! pass the depth test.
+  template <typename Output>
+  void drawTriangle( const Mat3x4& proj, const Vec2i& eMin, const Vec2i& eMax, const Output& pOutput );
+  //! Shade the iCount pixels of pPixels of the visibility buffer.
+  template <typename Shader>
+  void shadePixels( const Shader& shader, const int* pPixels, size_t iCount );
+
   Mat4               m_eMVP;
   Mat4               m_eMatMod;
+  Mat4               m_eMatPro;
   Mat4               m_eMatNrm;
   Vec4               m_eViewport;
+  Vec2i              m_eNumTiles;
   Image&             m_eImage;
   std::vector<float> m_fDepth;
   bool               m_bLighting;
+  bool               m_bDeferredShading = false;
+
+  std::vector<Visibility> m_pVisibility;
 };
 
 #endif
@@ -111,6 +111,7 @@ class Window {
   int             m_iWindowPositionY     = 100;
   int             m_iFrameNumber         = 0;
   int             m_iRenderingIndex      = 0;
+  int             m_iReorderDepth        = 0;
   double          m_dMouseX              = 0.0;
   double          m_dMouseY              = 0.0;
   double          m_dTime                = 0.0;
@@ -119,6 +120,7 @@ class Window {
   double          m_dTimePath            = 0.0;
   double          m_dLogStart            = 0.0;
   bool            m_bSoftwareRenderer    = false;
+  bool            m_bDeferredShading     = false;
   bool            m_bFullscreen          = false;
   bool            m_bFullscreenAsked     = false;
   bool            m_bReload              = false;
@@ -0,0 +1,120 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererDef.h"
+#include "PccRendererSequence.h"
+#include "PccRendererCacheWriter.h"
+#include "PccRendererCacheDirectory.h"
+
+#include "program_options_lite.h"
+
+// Ahead-of-time conversion of the point cloud sequences in the binary cache files of the renderer. The frames are read
+// by the tasks of the OpenMP threads, their duplicate points removal, Morton ordering and quantization run in parallel
+// by chunks of points, then the cache files, the sequence index and the optional container are written. The renderer
+// started with the same parameters only maps the cache files.
+
+struct ConverterParameters {
+  std::string m_pFile;
+  std::string m_pDir;
+  std::string m_pContainerFile;
+  std::string m_pCacheDir;
+  int         m_iFrameIndex   = 0;
+  int         m_iFrameNumber  = 0;
+  int         m_iDropDups     = 2;
+  int         m_iQuantization = 0;
+  int         m_iCacheSize    = 10240;
+  bool        m_bMortonOrder  = false;
+};
+
+static void printConverterHelp( df::program_options_lite::Options& eOptions,
+                                const std::string /*unused*/,
+                                df::program_options_lite::ErrorReporter& errorReporter ) {
+  printf( "%s", g_pCopyrightString.c_str() );
+  printf( "PccAppConverter configuration: input parameters must be:\n" );
+  doHelp( std::cout, eOptions );
+  errorReporter.is_errored = true;
+}
+
+static bool parseConverterCfg( int argc, char* argv[], ConverterParameters& params ) {
+  df::program_options_lite::Options       eOptions;
+  df::program_options_lite::ErrorReporter err;
+  // clang-format off
+  eOptions.addOptions()
+    ( "help",            printConverterHelp,                              "Print help."                                )
+    ( "f,PlyFile",       params.m_pFile,          std::string(""),        "Ply input filename."                        )
+    ( "d,PlyDir",        params.m_pDir,           std::string(""),        "Ply input directory."                       )
+    ( "n,frameNumber",   params.m_iFrameNumber,   0,                      "Frame number (0: all the files of the\n"
+      "  directory)."                                                                                                  )
+    ( "i,frameIndex",    params.m_iFrameIndex,    0,                      "Frame index."                               )
+    ( "dropdups",        params.m_iDropDups,      2,                      "Drop same coordinate points (0:No,\n"
+      "  1:drop, 2:average)."                                                                                          )
+    ( "mortonOrder",     params.m_bMortonOrder,   false,                  "Sort the points in Morton order."           )
+    ( "quantization",    params.m_iQuantization,  0,                      "Bits per coordinate of the positions of\n"
+      "  the non voxelized contents (0: lossless, max 16)."                                                            )
+    ( "createContainer", params.m_pContainerFile, std::string(""),        "Also write the frames in a single file\n"
+      "  container (.pcs)."                                                                                            )
+    ( "cacheDir",        params.m_pCacheDir,      std::string(""),        "Directory of the binary files (empty:\n"
+      "  .binary next to the sources)."                                                                                )
+    ( "cacheSize",       params.m_iCacheSize,     10240,                  "Size of the cache directory in MB (0: no\n"
+      "  limit)."                                                                                                      );
+  // clang-format on
+  setDefaults( eOptions );
+  try {
+    scanArgv( eOptions, argc, (const char**)argv, err );
+  } catch ( df::program_options_lite::ParseFailure& e ) {
+    printConverterHelp( eOptions, "", err );
+    std::cerr << "Parsing error: option: \"" << e.arg << "\" and value: \"" << e.val << "\" are not supported. \n";
+    return false;
+  }
+  if ( argc == 1 || err.is_errored ) {
+    printConverterHelp( eOptions, "", err );
+    return false;
+  }
+  if ( params.m_pFile.empty() && params.m_pDir.empty() ) {
+    printf( "Error: Ply file or director must be defined. \n" );
+    return false;
+  }
+  if ( !params.m_pFile.empty() && params.m_iFrameNumber <= 0 ) {
+    printf( "Error: Frame number value not supported, %d must be > 0 with a Ply file.\n", params.m_iFrameNumber );
+    return false;
+  }
+  if ( params.m_iQuantization < 0 || params.m_iQuantization > 16 ) {
+    printf( "Error: Quantization value not supported, %d not in[0;16].\n", params.m_iQuantization );
+    return false;
+  }
+  if ( params.m_iCacheSize < 0 ) {
+    printf( "Error: Cache size value not supported, %d must be >= 0.\n", params.m_iCacheSize );
+    return false;
+  }
+  return true;
+}
+
+int main( int argc, char* argv[] ) {
+  ConverterParameters params;
+  if ( !parseConverterCfg( argc, argv, params ) ) { return 0; }
+  auto     eStart = std::chrono::steady_clock::now();
+  if ( !params.m_pCacheDir.empty() ) {
+    const uint64_t iCacheSize = static_cast<uint64_t>( params.m_iCacheSize ) << 20;
+    CacheDirectory::getInstance().setDirectory( params.m_pCacheDir, iCacheSize );
+  }
+  Sequence eSequence;
+  eSequence.setDropDups( params.m_iDropDups );
+  eSequence.setMortonOrder( params.m_bMortonOrder );
+  eSequence.setQuantization( params.m_iQuantization );
+  // Streaming mode: each frame is released once its cache file is queued, the memory used by the conversion does not
+  // depend on the length of the sequence.
+  eSequence.setMemoryBudget( 1 );
+  eSequence.read( params.m_pFile, params.m_pDir, "", "", params.m_iFrameIndex, params.m_iFrameNumber, true );
+  if ( eSequence.getNumFrames() == 0 || eSequence.getObjectType() != ObjectType::POINTCLOUD ) {
+    printf( "PccAppConverter: no point cloud frame has been read \n" );
+    return -1;
+  }
+  if ( !params.m_pContainerFile.empty() && !eSequence.writeContainer( params.m_pContainerFile ) ) { return -1; }
+  CacheWriter::getInstance().flush();
+  Box& eBox = eSequence.getBox();
+  printf( "PccAppConverter: %d frames converted in %.3f s, box = [%f;%f][%f;%f][%f;%f] \n", eSequence.getNumFrames(),
+          std::chrono::duration<double>( std::chrono::steady_clock::now() - eStart ).count(), eBox.min()[0],
+          eBox.max()[0], eBox.min()[1], eBox.max()[1], eBox.min()[2], eBox.max()[2] );
+  return 0;
+}
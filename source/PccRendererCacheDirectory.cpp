@@ -0,0 +1,206 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererCacheDirectory.h"
+
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+// The fingerprint reads the size, the modification time, the first and the last g_iEndSize bytes and g_iNumSamples
+// blocks of g_iSampleSize bytes evenly spaced in the file: the sources on slow mounts are not read entirely to find
+// their cache entry. The samples alone miss the edits that keep the size of a file (fixed stride binary ply), the
+// modification time catches them: the copies of a source share their entry when they keep its time (cp -p, rsync -a).
+static const uint64_t g_iEndSize     = 65536;
+static const uint64_t g_iSampleSize  = 4096;
+static const uint64_t g_iNumSamples  = 64;
+static const int64_t  g_iTemporaryAge = 3600;
+
+static inline uint64_t hashBytes( uint64_t iHash, const uint8_t* pData, size_t iSize ) {
+  // FNV-1a 64 bits
+  for ( size_t i = 0; i < iSize; i++ ) { iHash = ( iHash ^ pData[i] ) * 0x100000001b3ULL; }
+  return iHash;
+}
+
+CacheDirectory& CacheDirectory::getInstance() {
+  static CacheDirectory eInstance;
+  return eInstance;
+}
+
+CacheDirectory::CacheDirectory() {}
+
+CacheDirectory::~CacheDirectory() {}
+
+void CacheDirectory::setDirectory( const std::string& sDirectory, uint64_t iMaxSize ) {
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  m_sDirectory = sDirectory;
+  while ( m_sDirectory.size() > 1 && ( m_sDirectory.back() == '/' || m_sDirectory.back() == '\\' ) ) {
+    m_sDirectory.pop_back();
+  }
+  m_iMaxSize = iMaxSize;
+  m_bScanned = false;
+  if ( !m_sDirectory.empty() && !dirExists( m_sDirectory ) ) {
+#ifdef WIN32
+    CreateDirectory( m_sDirectory.c_str(), NULL );
+#else
+    mkdir( m_sDirectory.c_str(), 0777 );
+#endif
+    if ( !dirExists( m_sDirectory ) ) {
+      printf( "CacheDirectory: can't create %s, the cache files are written next to the sources \n",
+              m_sDirectory.c_str() );
+      m_sDirectory.clear();
+    }
+  }
+}
+
+std::string CacheDirectory::getBinaryName( const std::string& sSource, int iDropDups, bool bMortonOrder ) {
+  uint64_t iFingerprint = 0;
+  if ( !isEnabled() || !getFingerprint( sSource, iFingerprint ) ) {
+    return ::getBinaryName( sSource, iDropDups, bMortonOrder );
+  }
+  return m_sDirectory + getSeparator() +
+         stringFormat( "%016llx_dup%d%s.bpcc", static_cast<unsigned long long>( iFingerprint ), iDropDups,
+                       bMortonOrder ? "_morton" : "" );
+}
+
+std::string CacheDirectory::getIndexName( const std::string& sSequence, int iDropDups ) {
+  if ( !isEnabled() ) { return ::getIndexName( sSequence, iDropDups ); }
+  // The index stores the names, sizes and times of the sources: it is named by the name of the sequence.
+  const uint64_t iHash = hashBytes( 0xcbf29ce484222325ULL, reinterpret_cast<const uint8_t*>( sSequence.data() ),
+                                    sSequence.size() );
+  return m_sDirectory + getSeparator() +
+         stringFormat( "%016llx_dup%d.bpcsi", static_cast<unsigned long long>( iHash ), iDropDups );
+}
+
+bool CacheDirectory::getFingerprint( const std::string& sSource, uint64_t& iFingerprint ) {
+  uint64_t iSize = 0;
+  int64_t  iTime = 0;
+  if ( !getFileStatus( sSource, iSize, iTime ) ) { return false; }
+  {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    auto                        it = m_pFingerprints.find( sSource );
+    if ( it != m_pFingerprints.end() && it->second.m_iSize == iSize && it->second.m_iTime == iTime ) {
+      iFingerprint = it->second.m_iFingerprint;
+      return true;
+    }
+  }
+  std::ifstream eFile( sSource.c_str(), std::ios::in | std::ios::binary );
+  if ( !eFile.is_open() ) { return false; }
+  std::vector<uint8_t> pBuffer( g_iEndSize );
+  uint64_t iHash = hashBytes( 0xcbf29ce484222325ULL, reinterpret_cast<const uint8_t*>( &iSize ), sizeof( iSize ) );
+  iHash          = hashBytes( iHash, reinterpret_cast<const uint8_t*>( &iTime ), sizeof( iTime ) );
+  auto     hashRange = [&]( uint64_t iOffset, uint64_t iLength ) {
+    eFile.seekg( static_cast<std::streamoff>( iOffset ) );
+    eFile.read( reinterpret_cast<char*>( pBuffer.data() ), static_cast<std::streamsize>( iLength ) );
+    iHash = hashBytes( iHash, pBuffer.data(), static_cast<size_t>( eFile.gcount() ) );
+    eFile.clear();
+  };
+  if ( iSize <= 2 * g_iEndSize + g_iNumSamples * g_iSampleSize ) {
+    for ( uint64_t iOffset = 0; iOffset < iSize; iOffset += g_iEndSize ) {
+      hashRange( iOffset, ( std::min )( g_iEndSize, iSize - iOffset ) );
+    }
+  } else {
+    hashRange( 0, g_iEndSize );
+    for ( uint64_t i = 0; i < g_iNumSamples; i++ ) {
+      hashRange( g_iEndSize + ( iSize - 2 * g_iEndSize - g_iSampleSize ) * i / ( g_iNumSamples - 1 ), g_iSampleSize );
+    }
+    hashRange( iSize - g_iEndSize, g_iEndSize );
+  }
+  iFingerprint = iHash;
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  Fingerprint&                eFingerprint = m_pFingerprints[sSource];
+  eFingerprint.m_iSize                     = iSize;
+  eFingerprint.m_iTime                     = iTime;
+  eFingerprint.m_iFingerprint              = iHash;
+  return true;
+}
+
+void CacheDirectory::touch( const std::string& sFilename ) {
+  if ( !isEnabled() ) { return; }
+#ifdef WIN32
+  _utime( sFilename.c_str(), nullptr );
+#else
+  utime( sFilename.c_str(), nullptr );
+#endif
+}
+
+void CacheDirectory::add( const std::string& sFilename, uint64_t iSize ) {
+  if ( !isEnabled() || m_iMaxSize == 0 || sFilename.compare( 0, m_sDirectory.size(), m_sDirectory ) != 0 ) { return; }
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  // The size is estimated from the writes of this process between two scans of the directory, the scans count the
+  // entries written by the other processes. The eviction keeps a margin to not scan the directory at each write.
+  if ( !m_bScanned ) {
+    m_iSize    = evict( m_iMaxSize );
+    m_bScanned = true;
+  }
+  m_iSize += iSize;
+  if ( m_iSize > m_iMaxSize ) { m_iSize = evict( m_iMaxSize / 10 * 9 ); }
+}
+
+uint64_t CacheDirectory::evict( uint64_t iTargetSize ) {
+  struct Entry {
+    std::string m_sFilename;
+    uint64_t    m_iSize;
+    int64_t     m_iTime;
+  };
+  std::vector<Entry> pEntries;
+  std::vector<std::string> pNames;
+#ifdef WIN32
+  WIN32_FIND_DATA eSearchData;
+  HANDLE          eHandle = FindFirstFile( ( m_sDirectory + "\\*" ).c_str(), &eSearchData );
+  while ( eHandle != INVALID_HANDLE_VALUE ) {
+    pNames.push_back( eSearchData.cFileName );
+    if ( FindNextFile( eHandle, &eSearchData ) == FALSE ) { break; }
+  }
+  FindClose( eHandle );
+#else
+  DIR* pDir = opendir( m_sDirectory.c_str() );
+  if ( pDir == nullptr ) { return 0; }
+  while ( struct dirent* pDirent = readdir( pDir ) ) { pNames.push_back( pDirent->d_name ); }
+  closedir( pDir );
+#endif
+  const int64_t iNow  = static_cast<int64_t>( time( nullptr ) );
+  uint64_t      iSize = 0;
+  for ( auto& sName : pNames ) {
+    Entry       eEntry;
+    std::string sExtension = getExtension( sName );
+    eEntry.m_sFilename     = m_sDirectory + getSeparator() + sName;
+    if ( !getFileStatus( eEntry.m_sFilename, eEntry.m_iSize, eEntry.m_iTime ) ) { continue; }
+    if ( sExtension == "bpcc" || sExtension == "bpcsi" ) {
+      pEntries.push_back( eEntry );
+      iSize += eEntry.m_iSize;
+    } else if ( sExtension == "tmp" && iNow - eEntry.m_iTime > g_iTemporaryAge ) {
+      // Temporary file left by a process that has been stopped during a write.
+      std::remove( eEntry.m_sFilename.c_str() );
+    }
+  }
+  if ( iSize <= iTargetSize ) { return iSize; }
+  // The files mapped by the readers are still valid once removed, the removals that fail are skipped.
+  std::sort( pEntries.begin(), pEntries.end(),
+             []( const Entry& eA, const Entry& eB ) { return eA.m_iTime < eB.m_iTime; } );
+  size_t iNumRemoved = 0;
+  for ( auto& eEntry : pEntries ) {
+    if ( iSize <= iTargetSize ) { break; }
+    if ( std::remove( eEntry.m_sFilename.c_str() ) == 0 ) {
+      iSize -= eEntry.m_iSize;
+      iNumRemoved++;
+    }
+  }
+  printf( "CacheDirectory: %zu entries evicted, %.1f MB used \n", iNumRemoved, iSize / 1048576. );
+  return iSize;
+}
+
+std::string CacheDirectory::getTemporaryName( const std::string& sFilename ) {
+#ifdef WIN32
+  return stringFormat( "%s.%d.tmp", sFilename.c_str(), _getpid() );
+#else
+  return stringFormat( "%s.%d.tmp", sFilename.c_str(), static_cast<int>( getpid() ) );
+#endif
+}
@@ -0,0 +1,77 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererCacheWriter.h"
+#include "PccRendererCacheDirectory.h"
+
+// The readers are blocked when the queued buffers exceed this size, the memory used by the queue stays bounded.
+static const size_t g_iMaxPendingSize = size_t( 512 ) << 20;
+
+CacheWriter& CacheWriter::getInstance() {
+  static CacheWriter eInstance;
+  return eInstance;
+}
+
+CacheWriter::CacheWriter() {}
+
+CacheWriter::~CacheWriter() {
+  {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    m_bStop = true;
+  }
+  m_eCondition.notify_all();
+  if ( m_eThread.joinable() ) { m_eThread.join(); }
+}
+
+void CacheWriter::push( const std::string& sFilename, std::vector<uint8_t>&& pBuffer ) {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  if ( !m_eThread.joinable() ) { m_eThread = std::thread( &CacheWriter::process, this ); }
+  m_eCondition.wait( eLock, [&] { return m_iPendingSize < g_iMaxPendingSize; } );
+  m_iPendingSize += pBuffer.size();
+  m_eQueue.emplace_back( sFilename, std::move( pBuffer ) );
+  m_eCondition.notify_all();
+}
+
+void CacheWriter::flush() {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  m_eCondition.wait( eLock, [&] { return m_eQueue.empty() && !m_bWriting; } );
+}
+
+void CacheWriter::process() {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  while ( true ) {
+    m_eCondition.wait( eLock, [&] { return m_bStop || !m_eQueue.empty(); } );
+    if ( m_eQueue.empty() ) { break; }
+    auto eElement = std::move( m_eQueue.front() );
+    m_eQueue.pop_front();
+    m_bWriting = true;
+    eLock.unlock();
+    std::string sDirectory = getDirectory( eElement.first );
+    if ( !dirExists( sDirectory ) ) {
+#ifdef WIN32
+      CreateDirectory( sDirectory.c_str(), NULL );
+#else
+      mkdir( sDirectory.c_str(), 0777 );
+#endif
+    }
+    // The concurrent readers never see a partial file: the temporary file is only renamed once complete.
+    std::string   sTemporary = CacheDirectory::getTemporaryName( eElement.first );
+    std::ofstream outfile( sTemporary.c_str(), std::ios::binary | std::ios::out );
+    outfile.write( reinterpret_cast<const char*>( eElement.second.data() ), eElement.second.size() );
+    outfile.close();
+#ifdef WIN32
+    if ( outfile ) { std::remove( eElement.first.c_str() ); }
+#endif
+    if ( !outfile || std::rename( sTemporary.c_str(), eElement.first.c_str() ) != 0 ) {
+      printf( "CacheWriter: can't write %s \n", eElement.first.c_str() );
+      std::remove( sTemporary.c_str() );
+    } else {
+      CacheDirectory::getInstance().add( eElement.first, eElement.second.size() );
+    }
+    eLock.lock();
+    m_iPendingSize -= eElement.second.size();
+    m_bWriting = false;
+    m_eCondition.notify_all();
+  }
+}
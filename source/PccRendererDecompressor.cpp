@@ -0,0 +1,278 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererDecompressor.h"
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+// The compressed file is read by g_iInputSize bytes and decompressed in blocks of g_iBlockSize bytes, at most
+// g_iQueueDepth blocks wait for the parser.
+static const size_t g_iInputSize  = size_t( 1 ) << 20;
+static const size_t g_iBlockSize  = size_t( 1 ) << 22;
+static const size_t g_iQueueDepth = 4;
+
+Decompressor::Decompressor() {}
+
+Decompressor::~Decompressor() { close(); }
+
+bool Decompressor::open( const std::string& sFilename ) {
+  close();
+  m_sFilename = sFilename;
+  m_eFile.open( sFilename.c_str(), std::ios::in | std::ios::binary );
+  if ( !m_eFile.is_open() ) { return false; }
+  uint8_t pMagic[4] = {0, 0, 0, 0};
+  m_eFile.read( reinterpret_cast<char*>( pMagic ), sizeof( pMagic ) );
+  m_eFile.clear();
+  m_eFile.seekg( 0 );
+  if ( pMagic[0] == 0x1f && pMagic[1] == 0x8b ) {
+    m_eFormat = FORMAT_GZIP;
+  } else if ( pMagic[0] == 0x28 && pMagic[1] == 0xb5 && pMagic[2] == 0x2f && pMagic[3] == 0xfd ) {
+    m_eFormat = FORMAT_ZSTD;
+  } else {
+    printf( "Decompressor: %s is not a gzip or zstd file \n", sFilename.c_str() );
+    m_eFile.close();
+    return false;
+  }
+#ifndef USE_ZLIB
+  if ( m_eFormat == FORMAT_GZIP ) {
+    printf( "Decompressor: %s can't be read, the renderer is built without zlib \n", sFilename.c_str() );
+    m_eFile.close();
+    return false;
+  }
+#endif
+#ifndef USE_ZSTD
+  if ( m_eFormat == FORMAT_ZSTD ) {
+    printf( "Decompressor: %s can't be read, the renderer is built without zstd \n", sFilename.c_str() );
+    m_eFile.close();
+    return false;
+  }
+#endif
+  m_eThread = std::thread( &Decompressor::process, this );
+  return true;
+}
+
+bool Decompressor::read( std::vector<uint8_t>& pBlock ) {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  m_eCondition.wait( eLock, [&] { return m_bEnd || !m_eQueue.empty(); } );
+  if ( m_eQueue.empty() ) { return false; }
+  std::swap( pBlock, m_eQueue.front() );
+  if ( m_eQueue.front().capacity() > 0 ) { m_pFree.push_back( std::move( m_eQueue.front() ) ); }
+  m_eQueue.pop_front();
+  m_eCondition.notify_all();
+  return true;
+}
+
+bool Decompressor::getError() {
+  // The errors detected at the end of the data (truncated file, checksum) are only known once all the data are read.
+  if ( m_eThread.joinable() ) {
+    std::vector<uint8_t> pBlock;
+    while ( read( pBlock ) ) {}
+  }
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  return m_bError;
+}
+
+void Decompressor::close() {
+  {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    m_bStop = true;
+  }
+  m_eCondition.notify_all();
+  if ( m_eThread.joinable() ) { m_eThread.join(); }
+  if ( m_eFile.is_open() ) { m_eFile.close(); }
+  m_eQueue.clear();
+  m_pFree.clear();
+  m_eFormat = FORMAT_UNKNOWN;
+  m_bEnd    = false;
+  m_bError  = false;
+  m_bStop   = false;
+}
+
+void Decompressor::process() {
+  const bool bValid = m_eFormat == FORMAT_GZIP ? decompressGzip() : decompressZstd();
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  if ( !bValid && !m_bStop ) {
+    printf( "Decompressor: %s is truncated or corrupted \n", m_sFilename.c_str() );
+    m_bError = true;
+  }
+  m_bEnd = true;
+  m_eCondition.notify_all();
+}
+
+size_t Decompressor::readInput( std::vector<uint8_t>& pInput ) {
+  pInput.resize( g_iInputSize );
+  m_eFile.read( reinterpret_cast<char*>( pInput.data() ), g_iInputSize );
+  return static_cast<size_t>( m_eFile.gcount() );
+}
+
+void Decompressor::getFreeBlock( std::vector<uint8_t>& pBlock ) {
+  {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    if ( !m_pFree.empty() ) {
+      pBlock = std::move( m_pFree.back() );
+      m_pFree.pop_back();
+    }
+  }
+  pBlock.resize( g_iBlockSize );
+}
+
+bool Decompressor::push( std::vector<uint8_t>& pBlock ) {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  m_eCondition.wait( eLock, [&] { return m_bStop || m_eQueue.size() < g_iQueueDepth; } );
+  if ( m_bStop ) { return false; }
+  m_eQueue.push_back( std::move( pBlock ) );
+  m_eCondition.notify_all();
+  return true;
+}
+
+bool Decompressor::decompressGzip() {
+#ifdef USE_ZLIB
+  z_stream eStream;
+  memset( &eStream, 0, sizeof( z_stream ) );
+  // 15 + 32: the gzip and zlib headers are detected by zlib.
+  if ( inflateInit2( &eStream, 15 + 32 ) != Z_OK ) { return false; }
+  std::vector<uint8_t> pInput, pBlock;
+  bool                 bValid = true, bEnd = false, bComplete = false;
+  while ( bValid && !bEnd ) {
+    getFreeBlock( pBlock );
+    eStream.next_out  = pBlock.data();
+    eStream.avail_out = static_cast<uInt>( pBlock.size() );
+    while ( bValid && eStream.avail_out > 0 ) {
+      if ( eStream.avail_in == 0 ) {
+        eStream.avail_in = static_cast<uInt>( readInput( pInput ) );
+        eStream.next_in  = pInput.data();
+        if ( eStream.avail_in == 0 ) {
+          bEnd = true;
+          break;
+        }
+      }
+      int iResult = inflate( &eStream, Z_NO_FLUSH );
+      bComplete   = iResult == Z_STREAM_END;
+      if ( bComplete ) {
+        // The files written by the parallel compressors are made of several gzip members.
+        iResult = inflateReset( &eStream );
+      }
+      bValid = iResult == Z_OK;
+    }
+    pBlock.resize( pBlock.size() - eStream.avail_out );
+    if ( !pBlock.empty() && !push( pBlock ) ) { break; }
+  }
+  inflateEnd( &eStream );
+  return bValid && bComplete;
+#else
+  return false;
+#endif
+}
+
+bool Decompressor::decompressZstd() {
+#ifdef USE_ZSTD
+  ZSTD_DStream* pStream = ZSTD_createDStream();
+  if ( pStream == nullptr ) { return false; }
+  ZSTD_initDStream( pStream );
+  std::vector<uint8_t> pInput, pBlock;
+  ZSTD_inBuffer        eInput  = {nullptr, 0, 0};
+  size_t               iResult = 0;
+  bool                 bValid = true, bEnd = false;
+  while ( bValid && !bEnd ) {
+    getFreeBlock( pBlock );
+    ZSTD_outBuffer eOutput = {pBlock.data(), pBlock.size(), 0};
+    while ( bValid && eOutput.pos < eOutput.size ) {
+      if ( eInput.pos == eInput.size ) {
+        eInput.size = readInput( pInput );
+        eInput.src  = pInput.data();
+        eInput.pos  = 0;
+        if ( eInput.size == 0 ) {
+          bEnd = true;
+          break;
+        }
+      }
+      // The result is 0 once a frame is complete, the next frames of the file are decoded by the same calls.
+      iResult = ZSTD_decompressStream( pStream, &eOutput, &eInput );
+      bValid  = !ZSTD_isError( iResult );
+    }
+    pBlock.resize( eOutput.pos );
+    if ( !pBlock.empty() && !push( pBlock ) ) { break; }
+  }
+  ZSTD_freeDStream( pStream );
+  return bValid && iResult == 0;
+#else
+  return false;
+#endif
+}
+
+bool DecompressedStream::Buffer::open( const std::string& sFilename, bool bSeekable ) {
+  close();
+  m_bSeekable = bSeekable;
+  return m_eDecompressor.open( sFilename );
+}
+
+void DecompressedStream::Buffer::close() {
+  m_eDecompressor.close();
+  m_pData.clear();
+  m_pBlock.clear();
+  m_iDataPosition = 0;
+  setg( nullptr, nullptr, nullptr );
+}
+
+DecompressedStream::Buffer::int_type DecompressedStream::Buffer::underflow() {
+  if ( gptr() < egptr() ) { return traits_type::to_int_type( *gptr() ); }
+  if ( !m_eDecompressor.read( m_pBlock ) ) { return traits_type::eof(); }
+  size_t iPosition = 0;
+  if ( m_bSeekable ) {
+    iPosition = m_pData.size();
+    m_pData.insert( m_pData.end(), m_pBlock.begin(), m_pBlock.end() );
+  } else {
+    m_iDataPosition += m_pData.size();
+    std::swap( m_pData, m_pBlock );
+  }
+  char* pData = reinterpret_cast<char*>( m_pData.data() );
+  setg( pData, pData + iPosition, pData + m_pData.size() );
+  return traits_type::to_int_type( *gptr() );
+}
+
+DecompressedStream::Buffer::pos_type DecompressedStream::Buffer::seekoff( off_type                iOffset,
+                                                                          std::ios_base::seekdir  eDirection,
+                                                                          std::ios_base::openmode eMode ) {
+  const uint64_t iCurrent = m_iDataPosition + static_cast<uint64_t>( gptr() - eback() );
+  if ( eDirection == std::ios_base::end ) {
+    if ( !m_bSeekable ) { return pos_type( off_type( -1 ) ); }
+    while ( underflow() != traits_type::eof() ) { setg( eback(), egptr(), egptr() ); }
+    return seekpos( pos_type( static_cast<off_type>( m_pData.size() ) + iOffset ), eMode );
+  }
+  return seekpos( pos_type( ( eDirection == std::ios_base::cur ? static_cast<off_type>( iCurrent ) : 0 ) + iOffset ),
+                  eMode );
+}
+
+DecompressedStream::Buffer::pos_type DecompressedStream::Buffer::seekpos( pos_type                iPosition,
+                                                                          std::ios_base::openmode eMode ) {
+  // Only the decompressed data kept in memory can be reached: the current block or all the data if seekable.
+  const off_type iOffset = static_cast<off_type>( iPosition ) - static_cast<off_type>( m_iDataPosition );
+  if ( !( eMode & std::ios_base::in ) || iOffset < 0 || iOffset > static_cast<off_type>( m_pData.size() ) ) {
+    return pos_type( off_type( -1 ) );
+  }
+  char* pData = reinterpret_cast<char*>( m_pData.data() );
+  setg( pData, pData + iOffset, pData + m_pData.size() );
+  return iPosition;
+}
+
+DecompressedStream::DecompressedStream() : std::istream( nullptr ) { rdbuf( &m_eBuffer ); }
+
+DecompressedStream::~DecompressedStream() {}
+
+bool DecompressedStream::open( const std::string& sFilename, bool bSeekable ) {
+  clear();
+  m_bOpen = m_eBuffer.open( sFilename, bSeekable );
+  if ( !m_bOpen ) { setstate( std::ios::failbit ); }
+  return m_bOpen;
+}
+
+void DecompressedStream::close() {
+  m_eBuffer.close();
+  m_bOpen = false;
+}
@@ -6,6 +6,7 @@
 
 #include "PccRendererWindow.h"
 #include "PccRendererSequence.h"
+#include "PccRendererCacheDirectory.h"
 
 double getTime() {
   static std::chrono::high_resolution_clock::time_point eStart = std::chrono::high_resolution_clock::now();
@@ -15,12 +16,19 @@ double getTime() {
 void readSequence( RendererParameters& params, Sequence& eSequence ) {
   eSequence.setFps( params.getFps() );
   eSequence.setDropDups( params.getDropDups() );
+  eSequence.setMortonOrder( params.getMortonOrder() );
+  eSequence.setQuantization( params.getQuantization() );
+  // Optional attributes used by the render mode, the other attributes are read when they are displayed.
+  eSequence.setAttributes( params.getSoftwareRenderer() ? 0 : ATTRIBUTE_MULTI_COLOR );
   eSequence.setPlayBackward( params.getPlayBackward() );
-  eSequence.readFile( params.getFile(), params.getFrameIndex(), params.getFrameNumber(), params.getBinaryFile() );
-  eSequence.readFile( params.getFileSrc(), params.getFrameIndex(), params.getFrameNumber(), params.getBinaryFile(),
-                      true );
-  eSequence.readDirectory( params.getDir(), params.getFrameNumber(), params.getBinaryFile() );
-  eSequence.readDirectory( params.getDirSrc(), params.getFrameNumber(), params.getBinaryFile(), true );
+  eSequence.setMemoryBudget( static_cast<size_t>( params.getMemoryBudget() ) << 20 );
+  eSequence.setIoPrefetch( params.getIoPrefetch() );
+  eSequence.setCompressedBudget( static_cast<size_t>( params.getCompressedBudget() ) << 20 );
+  eSequence.read( params.getFile(), params.getDir(), params.getFileSrc(), params.getDirSrc(), params.getFrameIndex(),
+                  params.getFrameNumber(), params.getBinaryFile() );
+}
+
+void initSequence( RendererParameters& params, Sequence& eSequence ) {
   if ( params.getBoxSize() > 0 ) {
     eSequence.setBoxSize( (float)params.getBoxSize() );
   } else {
@@ -30,17 +38,24 @@ void readSequence( RendererParameters& params, Sequence& eSequence ) {
     printf( "Sequence configuration is not correct\n" );
     exit( 0 );
   }
+  // Write the frames in a single file container before the normalization
+  if ( !params.getContainerFile().empty() ) { eSequence.writeContainer( params.getContainerFile() ); }
+
   // Normalize objects position and size
   eSequence.normalize( params.getScaleMode(), params.getCenter() );
+
+  // Start loading the frames in background if the sequence doesn't fit in the memory budget
+  eSequence.startPrefetch();
 }
 
 void readScene( RendererParameters& params, Sequence& eScene ) {
-  if ( !params.getScenePath().empty() ) {
-    eScene.readFile( params.getScenePath(), 0, 1, false );
-    if ( eScene.getNumFrames() == 0 ) {
-      printf( "Can't load scene object: %s \n", params.getScenePath().c_str() );
-      exit( 0 );
-    }
+  if ( !params.getScenePath().empty() ) { eScene.read( params.getScenePath(), "", "", "", 0, 1, false ); }
+}
+
+void initScene( RendererParameters& params, Sequence& eScene ) {
+  if ( !params.getScenePath().empty() && eScene.getNumFrames() == 0 ) {
+    printf( "Can't load scene object: %s \n", params.getScenePath().c_str() );
+    exit( 0 );
   }
 }
 
@@ -53,9 +68,24 @@ int main( int argc, char* argv[] ) {
   if ( !params.parseCfg( argc, argv ) ) { return 0; }
   params.print();
 
-  // Read objects, source and background scene
-  readSequence( params, eSequence );
-  readScene( params, eSequence );
+  // Cache directory used by all the inputs, configured before they are read in parallel.
+  if ( !params.getCacheDir().empty() ) {
+    const uint64_t iCacheSize = static_cast<uint64_t>( params.getCacheSize() ) << 20;
+    CacheDirectory::getInstance().setDirectory( params.getCacheDir(), iCacheSize );
+  }
+
+  // Read objects, source and background scene: the frames of all the inputs are tasks of the same parallel region,
+  // the threads that have finished their frames help with the frames of the other inputs.
+#pragma omp parallel
+#pragma omp single
+  {
+#pragma omp task
+    readSequence( params, eSequence );
+#pragma omp task
+    readScene( params, eScene );
+  }
+  initSequence( params, eSequence );
+  initScene( params, eScene );
 
   // Create window
   Window eWindow( std::string( "PccAppRenderer - MPEG 3DG Renderer by InterDigital" ), params );
@@ -0,0 +1,69 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererMemoryMap.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+MemoryMap::MemoryMap() {}
+
+MemoryMap::~MemoryMap() { close(); }
+
+bool MemoryMap::open( const std::string& sFilename, bool bSequential ) {
+  close();
+#ifdef WIN32
+  m_hFile = CreateFileA( sFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         bSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL );
+  if ( m_hFile == INVALID_HANDLE_VALUE ) { return false; }
+  LARGE_INTEGER iSize;
+  if ( !GetFileSizeEx( m_hFile, &iSize ) || iSize.QuadPart == 0 ) {
+    close();
+    return false;
+  }
+  m_hMapping = CreateFileMappingA( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+  if ( m_hMapping == nullptr ) {
+    close();
+    return false;
+  }
+  m_pData = static_cast<const uint8_t*>( MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 ) );
+  if ( m_pData == nullptr ) {
+    close();
+    return false;
+  }
+  m_iSize = static_cast<size_t>( iSize.QuadPart );
+#else
+  int iFile = ::open( sFilename.c_str(), O_RDONLY );
+  if ( iFile < 0 ) { return false; }
+  struct stat eStat;
+  if ( fstat( iFile, &eStat ) != 0 || eStat.st_size == 0 ) {
+    ::close( iFile );
+    return false;
+  }
+  void* pData = mmap( nullptr, static_cast<size_t>( eStat.st_size ), PROT_READ, MAP_PRIVATE, iFile, 0 );
+  ::close( iFile );
+  if ( pData == MAP_FAILED ) { return false; }
+  if ( bSequential ) { madvise( pData, static_cast<size_t>( eStat.st_size ), MADV_SEQUENTIAL ); }
+  m_pData = static_cast<const uint8_t*>( pData );
+  m_iSize = static_cast<size_t>( eStat.st_size );
+#endif
+  return true;
+}
+
+void MemoryMap::close() {
+#ifdef WIN32
+  if ( m_pData != nullptr ) { UnmapViewOfFile( m_pData ); }
+  if ( m_hMapping != nullptr ) { CloseHandle( m_hMapping ); }
+  if ( m_hFile != INVALID_HANDLE_VALUE ) { CloseHandle( m_hFile ); }
+  m_hMapping = nullptr;
+  m_hFile    = INVALID_HANDLE_VALUE;
+#else
+  if ( m_pData != nullptr ) { munmap( const_cast<uint8_t*>( m_pData ), m_iSize ); }
+#endif
+  m_pData = nullptr;
+  m_iSize = 0;
+}
@@ -5,6 +5,7 @@
 
 #include "PccRendererObjectMesh.h"
 #include "PccRendererShader.h"
+#include "PccRendererDecompressor.h"
 
 #include <tinyply.h>
 
@@ -28,11 +29,12 @@ static const std::string g_pMeshVertexShader = SHADER(
   out vec3 Normal;
   uniform mat4 ProjMat;
   uniform mat4 ModMat;
+  uniform mat4 ObjMat;
   void main() {
-    gl_Position = ProjMat * ModMat * vec4( position, 1.f );
+    gl_Position = ProjMat * ModMat * ObjMat * vec4( position, 1.f );
     TexCoords = texCoords;
     Color = color;
-    Normal = vec3( transpose( inverse( ModMat ) ) * vec4( normal, 0.f ) );
+    Normal = vec3( transpose( inverse( ModMat * ObjMat ) ) * vec4( normal, 0.f ) );
   }
 );
 
@@ -46,13 +48,14 @@ static const std::string g_pVertexVertexShader = SHADER(
   out vec3 Normal;
   uniform mat4  ProjMat;
   uniform mat4  ModMat;
+  uniform mat4  ObjMat;
   uniform float PointSize;
   void main() {
-    gl_Position = ProjMat * ModMat * vec4( position, 1.f );
+    gl_Position = ProjMat * ModMat * ObjMat * vec4( position, 1.f );
     gl_PointSize = PointSize * 4750.0 / gl_Position.w;
     TexCoords = texCoords;
     Color = color;
-    Normal = vec3( transpose( inverse( ModMat ) ) * vec4( normal, 0.f ) );
+    Normal = vec3( transpose( inverse( ModMat * ObjMat ) ) * vec4( normal, 0.f ) );
   }  
 );
 
@@ -265,14 +268,6 @@ void Mesh::unload() {
   }
 }
 
-void Mesh::scale( Vec3 center, float scale ) {
-  for ( auto& point : m_eVertices ) { point.position_ = ( point.position_ - center ) * scale; }
-}
-
-void Mesh::center( Vec3 center ) {
-  for ( auto& ePoint : m_eVertices ) { ePoint.position_ += center; }
-}
-
 void Mesh::recomputeBoundingBox() {
   m_eBox = Box();
   for ( auto& point : m_eVertices ) { m_eBox.update( point.position_ ); }
@@ -385,7 +380,7 @@ void ObjectMesh::loadProgram() {
 }
 
 bool ObjectMesh::read( std::string path, int32_t framesIndex ) {
-  auto ext = getExtension( path );
+  auto ext = getContentExtension( path );
   if ( ext == "obj" ) return readObj( path, framesIndex );
   if ( ext == "ply" ) return readPly( path, framesIndex );
   return false;
@@ -397,17 +392,27 @@ bool ObjectMesh::readObj( std::string path, int32_t framesIndex ) {
   m_iNumTextures = 0;
   m_eFilename    = createFilename( path, framesIndex );
   m_eDirectory   = getDirectory( m_eFilename );
-  tinyobj::ObjReaderConfig readerConfig;
-  tinyobj::ObjReader       reader;
-  readerConfig.mtl_search_path = m_eDirectory;
-  if ( !reader.ParseFromFile( m_eFilename, readerConfig ) ) {
-    if ( !reader.Error().empty() ) { std::cerr << "TinyObjReader: " << reader.Error(); }
+  tinyobj::attrib_t                attrib;
+  std::vector<tinyobj::shape_t>    shapes;
+  std::vector<tinyobj::material_t> materials;
+  std::string                      warning, error;
+  bool                             bRead = false;
+  if ( isCompressed( m_eFilename ) ) {
+    // The obj is parsed while the decompression thread inflates the next blocks, the materials are not compressed.
+    DecompressedStream          eStream;
+    tinyobj::MaterialFileReader eMaterialReader( m_eDirectory );
+    bRead = eStream.open( m_eFilename ) &&
+            tinyobj::LoadObj( &attrib, &shapes, &materials, &warning, &error, &eStream, &eMaterialReader ) &&
+            !eStream.getError();
+  } else {
+    bRead = tinyobj::LoadObj( &attrib, &shapes, &materials, &warning, &error, m_eFilename.c_str(),
+                              m_eDirectory.c_str() );
+  }
+  if ( !bRead ) {
+    if ( !error.empty() ) { std::cerr << "TinyObjReader: " << error; }
     exit( 1 );
   }
-  if ( !reader.Warning().empty() ) { std::cout << "TinyObjReader: " << reader.Warning(); }
-  auto& attrib    = reader.GetAttrib();
-  auto& shapes    = reader.GetShapes();
-  auto& materials = reader.GetMaterials();
+  if ( !warning.empty() ) { std::cout << "TinyObjReader: " << warning; }
   // PrintInfo( attrib, shapes, materials );
   m_eMeshes.resize( shapes.size() );
   bool bUVCoordinates = false;
@@ -452,7 +457,7 @@ bool ObjectMesh::readObj( std::string path, int32_t framesIndex ) {
     if ( tid >= 0 ) {
       std::string diffuse_texname = materials.size() > 0 ? materials[tid].diffuse_texname : std::string();
       if ( bUVCoordinates && diffuse_texname.empty() ) {
-        diffuse_texname = std::string( getBasename( getRemoveExtension( m_eFilename ) ) + ".png" );
+        diffuse_texname = std::string( getBasename( getRemoveContentExtension( m_eFilename ) ) + ".png" );
       }
       readTextures( diffuse_texname, "texture_diffuse", m_eMeshes[s].getTextures() );
       if ( bUVSupOne ) {
@@ -551,7 +556,14 @@ bool ObjectMesh::readPly( std::string path, int32_t framesIndex ) {
   m_eDirectory   = getDirectory( m_eFilename );
 
   std::unique_ptr<std::istream> file_stream;
-  file_stream.reset( new std::ifstream( m_eFilename.c_str(), std::ios::binary ) );
+  if ( isCompressed( m_eFilename ) ) {
+    // tinyply reads the data twice to size the list properties: the decompressed data are kept to seek backward.
+    auto pStream = new DecompressedStream();
+    pStream->open( m_eFilename, true );
+    file_stream.reset( pStream );
+  } else {
+    file_stream.reset( new std::ifstream( m_eFilename.c_str(), std::ios::binary ) );
+  }
   if (!file_stream || file_stream->fail()) {
     printf("failed to open: %s \n", m_eFilename.c_str());
     return false;
@@ -654,7 +666,7 @@ bool ObjectMesh::readPly( std::string path, int32_t framesIndex ) {
   if ( tid >= 0 ) {
     std::string diffuse_texname = std::string();
     if ( bUVCoordinates && diffuse_texname.empty() ) {
-      diffuse_texname = std::string( getBasename( getRemoveExtension( m_eFilename ) ) + ".png" );
+      diffuse_texname = std::string( getBasename( getRemoveContentExtension( m_eFilename ) ) + ".png" );
     }
     readTextures( diffuse_texname, "texture_diffuse", m_eMeshes[0].getTextures() );
     if ( bUVSupOne ) {
@@ -708,18 +720,6 @@ void ObjectMesh::recomputeBoundingBox() {
   }
 }
 
-void ObjectMesh::center( Box box, float fBoxSize ) {
-  Vec3 center = fBoxSize / 2.f - ( box.min() + ( box.max() - box.min() ) / 2.f );
-  for ( auto& mesh : m_eMeshes ) { mesh.center( center ); }
-}
-
-void ObjectMesh::scale( Box box, float fBoxSize ) {
-  if ( fBoxSize != 0.f ) {
-    float fScale = fBoxSize / box.getMaxSize();
-    for ( auto& mesh : m_eMeshes ) { mesh.scale( box.min(), fScale ); }
-  }
-}
-
 std::string ObjectMesh::getInformation() {
   if ( m_iNumTextures > 0 ) {
     return stringFormat( " Points   = %9d Faces   = %8d with %d textures image%c", m_iNumVertices, m_iNumFaces,
@@ -5,6 +5,16 @@
 #include "PccRendererObjectPointcloud.h"
 #include "PccRendererShader.h"
 #include "PccRendererPrimitive.h"
+#include "PccRendererMemoryMap.h"
+#include "PccRendererDecompressor.h"
+#include "PccRendererCacheWriter.h"
+#include "PccRendererCacheDirectory.h"
+#include "PccRendererPrefetcher.h"
+#include "PccRendererSequenceContainer.h"
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -31,6 +41,7 @@ int32_t              ObjectPointcloud::m_iProgramIndex = 0;
 static const std::string g_pPointVertexShader = SHADER(
   uniform mat4  ProjMat;
   uniform mat4  ModMat;
+  uniform mat4  ObjMat;
   uniform int   count;
   uniform int   mode;
   uniform vec3  posCamera;  
@@ -57,7 +68,7 @@ static const std::string g_pPointVertexShader = SHADER(
         vColor = colorM[mode];  
       }      
     }
-    gl_Position = ProjMat * ModMat * vec4( point, 1.f );
+    gl_Position = ProjMat * ModMat * ObjMat * vec4( point, 1.f );
     gl_PointSize = PointSize *  4750.0 / gl_Position.w;
   }
 );
@@ -99,13 +110,14 @@ static const std::string g_pSplatGeometryShader = SHADER(
   layout( triangle_strip, max_vertices = 4) out;  
   uniform mat4  ProjMat;
   uniform mat4  ModMat;
+  uniform mat4  ObjMat;
   uniform float PointSize;
   in  vec4  vColor [];
   out vec4  fColor;
   out vec2  fCoord;
   void main() {
     for ( int i = 0; i < gl_in.length(); i++)  {
-      vec4 pos =  ProjMat * ModMat * gl_in[i].gl_Position;
+      vec4 pos =  ProjMat * ModMat * ObjMat * gl_in[i].gl_Position;
       fColor  = vColor[i];
       fCoord  = vec2(  1,-1 ); gl_Position = pos + ProjMat * ( PointSize * vec4(  1, -1, 0, 0 ) ); EmitVertex();
       fCoord  = vec2(  1, 1 ); gl_Position = pos + ProjMat * ( PointSize * vec4(  1,  1, 0, 0 ) ); EmitVertex();
@@ -122,6 +134,7 @@ static const std::string g_pBlendedSplatGeometryShader = SHADER(
 layout(triangle_strip, max_vertices = 3) out;
 uniform mat4  ProjMat;
 uniform mat4  ModMat;
+uniform mat4  ObjMat;
 uniform float PointSize;
 in  vec4  vColor[];
 out vec4  fColor;
@@ -129,7 +142,7 @@ out vec2  fCoord;
 const vec2 coord[] = vec2[3]( vec2(0.0,2.0), vec2(sqrt(3.0),-1.0), vec2(-sqrt(3.0),-1.0));
 void main() {
     for (int i = 0; i < gl_in.length(); i++) {
-        vec4 pos = ProjMat * ModMat * gl_in[i].gl_Position;
+        vec4 pos = ProjMat * ModMat * ObjMat * gl_in[i].gl_Position;
         fColor = vColor[i];
         fCoord = coord[0]; gl_Position = pos + ProjMat * (PointSize * vec4(coord[0], 0, 0)); EmitVertex();
         fCoord = coord[1]; gl_Position = pos + ProjMat * (PointSize * vec4(coord[1], 0, 0)); EmitVertex();
@@ -146,6 +159,7 @@ static const std::string g_pCubeGeometryShader = SHADER(
   layout( triangle_strip, max_vertices = 32 ) out;
   uniform mat4 ProjMat;
   uniform mat4 ModMat;
+  uniform mat4 ObjMat;
   uniform float PointSize;
   uniform int   DepthMap;
   in  vec4 vColor[];
@@ -156,7 +170,7 @@ static const std::string g_pCubeGeometryShader = SHADER(
     float d = PointSize / 2.f; 
     for( int i = 0; i < gl_in.length(); i++ ) {
       mat4 eMat = ProjMat * ModMat;
-      vec4 ePos = eMat * gl_in[i].gl_Position;
+      vec4 ePos = eMat * ObjMat * gl_in[i].gl_Position;
       if( DepthMap == 1 ) {
         float value = 0.2f + 0.6f * ( ePos[2] - fMin ) / ( fMax - fMin ); 
         if      ( ePos[2] > fMax )  fColor = vec4( 0.8f, 0.8f, 0.8f, 1.f );
@@ -319,9 +333,16 @@ void ObjectPointcloud::allocate( bool bAlpha,
   m_pColors4.clear();
   m_pNormals.clear();
   m_pTypes.clear();
+  m_pMultiColors3.clear();
+  // The optional attributes that are not requested are not allocated and are skipped by the readers.
+  const bool bMultiColor = m_eRigParameters.getCount() > 0;
+  m_iSkippedAttributes   = ( bNormal && !( m_iAttributes & ATTRIBUTE_NORMAL ) ? ATTRIBUTE_NORMAL : 0 ) |
+                         ( bType && !( m_iAttributes & ATTRIBUTE_TYPE ) ? ATTRIBUTE_TYPE : 0 ) |
+                         ( bMultiColor && !( m_iAttributes & ATTRIBUTE_MULTI_COLOR ) ? ATTRIBUTE_MULTI_COLOR : 0 );
   m_bAlpha        = bAlpha;
-  m_bNormal       = bNormal;
-  m_bType         = bType;
+  m_bNormal       = bNormal && ( m_iAttributes & ATTRIBUTE_NORMAL );
+  m_bType         = bType && ( m_iAttributes & ATTRIBUTE_TYPE );
+  m_bMultiColor   = bMultiColor && ( m_iAttributes & ATTRIBUTE_MULTI_COLOR );
   m_bSort         = false;
   m_iNumPoints    = iNumPoints;
   m_iNumDuplicate = iNumDuplicate;
@@ -336,25 +357,99 @@ void ObjectPointcloud::allocate( bool bAlpha,
   }
   if ( m_bNormal ) { m_pNormals.resize( iNumPoints ); }
   if ( m_bType ) { m_pTypes.resize( iNumPoints ); }
-  if ( m_eRigParameters.getCount() > 0 ) { m_pMultiColors3.resize( m_eRigParameters.getCount() * iNumPoints ); }
+  if ( m_bMultiColor ) { m_pMultiColors3.resize( m_eRigParameters.getCount() * iNumPoints ); }
 }
 
-void ObjectPointcloud::setBox( float fXMin, float fXMax, float fYMin, float fYMax, float fZMin, float fZMax ) {
-  m_eBox = Box( Vec3( fXMin, fYMin, fZMin ), Vec3( fXMax, fYMax, fZMax ) );
+void ObjectPointcloud::dropAttributes() {
+  if ( m_bNormal && !( m_iAttributes & ATTRIBUTE_NORMAL ) ) {
+    PointVector<Normal>().swap( m_pNormals );
+    m_bNormal = false;
+    m_iSkippedAttributes |= ATTRIBUTE_NORMAL;
+  }
+  if ( m_bType && !( m_iAttributes & ATTRIBUTE_TYPE ) ) {
+    PointVector<uint8_t>().swap( m_pTypes );
+    m_bType = false;
+    m_iSkippedAttributes |= ATTRIBUTE_TYPE;
+  }
+  if ( m_bMultiColor && !( m_iAttributes & ATTRIBUTE_MULTI_COLOR ) ) {
+    PointVector<Color3u8>().swap( m_pMultiColors3 );
+    m_bMultiColor = false;
+    m_iSkippedAttributes |= ATTRIBUTE_MULTI_COLOR;
+  }
 }
 
-void ObjectPointcloud::center( Box box, float fBoxSize ) {
-  Vec3 center = fBoxSize / 2.f - ( box.min() + ( box.max() - box.min() ) / 2.f );
-  for ( auto& ePoint : m_pPoints ) { ePoint += center; }
+bool ObjectPointcloud::copyAttributes( ObjectPointcloud& eObject ) {
+  if ( eObject.m_iNumPoints != m_iNumPoints ) { return false; }
+  if ( !m_bNormal && eObject.m_bNormal ) {
+    m_pNormals.swap( eObject.m_pNormals );
+    m_bNormal = true;
+    m_iSkippedAttributes &= ~ATTRIBUTE_NORMAL;
+  }
+  if ( !m_bType && eObject.m_bType ) {
+    m_pTypes.swap( eObject.m_pTypes );
+    m_bType = true;
+    m_iSkippedAttributes &= ~ATTRIBUTE_TYPE;
+  }
+  if ( !m_bMultiColor && eObject.m_bMultiColor ) {
+    m_pMultiColors3.swap( eObject.m_pMultiColors3 );
+    m_bMultiColor = true;
+    m_iSkippedAttributes &= ~ATTRIBUTE_MULTI_COLOR;
+  }
+  m_iAttributes = eObject.m_iAttributes;
+  return true;
 }
 
-void ObjectPointcloud::scale( Box box, float fBoxSize ) {
-  if ( fBoxSize != 0.f ) {
-    float fScale = fBoxSize / box.getMaxSize();
-    for ( auto& ePoint : m_pPoints ) { ePoint = ( ePoint - box.min() ) * fScale; }
-  } else {
-    printf( "ObjectPointcloud: ignore scale to box of size 0\n" );
+//! Hash of an array by words of 64 bits.
+static uint64_t hashArray( uint64_t iHash, const void* pData, size_t iSize ) {
+  const uint8_t* pBytes = static_cast<const uint8_t*>( pData );
+  uint64_t       iWord  = 0;
+  size_t         i      = 0;
+  for ( ; i + sizeof( uint64_t ) <= iSize; i += sizeof( uint64_t ) ) {
+    memcpy( &iWord, pBytes + i, sizeof( uint64_t ) );
+    iHash = ( iHash ^ iWord ) * 0xFF51AFD7ED558CCDull;
+    iHash ^= iHash >> 32;
   }
+  iWord = iSize;
+  if ( i < iSize ) { memcpy( &iWord, pBytes + i, iSize - i ); }
+  iHash = ( iHash ^ iWord ) * 0xFF51AFD7ED558CCDull;
+  return iHash ^ ( iHash >> 32 );
+}
+
+template <typename Vector>
+static inline uint64_t hashVector( uint64_t iHash, const Vector& pData ) {
+  return hashArray( iHash, pData.data(), pData.size() * sizeof( typename Vector::value_type ) );
+}
+
+template <typename Vector>
+static inline bool isSameVector( const Vector& pA, const Vector& pB ) {
+  return pA.size() == pB.size() &&
+         ( pA.empty() || memcmp( pA.data(), pB.data(), pA.size() * sizeof( typename Vector::value_type ) ) == 0 );
+}
+
+uint64_t ObjectPointcloud::getContentHash() {
+  const int pFlags[6] = {m_iNumPoints, m_iNumDuplicate,    m_bAlpha, m_bNormal, m_bType,
+                         static_cast<int>( getNumMultiColors() )};
+  uint64_t  iHash     = hashArray( 0x9E3779B97F4A7C15ull, pFlags, sizeof( pFlags ) );
+  iHash               = hashVector( iHash, m_pPoints );
+  iHash               = hashVector( iHash, m_pColors3 );
+  iHash               = hashVector( iHash, m_pColors4 );
+  iHash               = hashVector( iHash, m_pNormals );
+  iHash               = hashVector( iHash, m_pTypes );
+  return hashVector( iHash, m_pMultiColors3 );
+}
+
+bool ObjectPointcloud::isSameContent( ObjectPointcloud& eObject ) {
+  return m_iNumPoints == eObject.m_iNumPoints && m_iNumDuplicate == eObject.m_iNumDuplicate &&
+         m_bAlpha == eObject.m_bAlpha && m_bNormal == eObject.m_bNormal && m_bType == eObject.m_bType &&
+         m_bMultiColor == eObject.m_bMultiColor && isSameVector( m_pPoints, eObject.m_pPoints ) &&
+         isSameVector( m_pColors3, eObject.m_pColors3 ) && isSameVector( m_pColors4, eObject.m_pColors4 ) &&
+         isSameVector( m_pNormals, eObject.m_pNormals ) && isSameVector( m_pTypes, eObject.m_pTypes ) &&
+         isSameVector( m_pMultiColors3, eObject.m_pMultiColors3 ) &&
+         isSameVector( m_eRigParameters.getMatrix(), eObject.m_eRigParameters.getMatrix() );
+}
+
+void ObjectPointcloud::setBox( float fXMin, float fXMax, float fYMin, float fYMax, float fZMin, float fZMax ) {
+  m_eBox = Box( Vec3( fXMin, fYMin, fZMin ), Vec3( fXMax, fYMax, fZMax ) );
 }
 
 void ObjectPointcloud::recomputeBoundingBox() {
@@ -362,49 +457,118 @@ void ObjectPointcloud::recomputeBoundingBox() {
   for ( auto& ePoint : m_pPoints ) { m_eBox.update( ePoint ); }
 }
 
+//! Hash of a position: -0 and +0 are merged to be consistent with the float comparisons.
+static inline uint64_t getPositionHash( const Point& ePoint ) {
+  uint64_t iHash = 0x9E3779B97F4A7C15ull;
+  for ( int c = 0; c < 3; c++ ) {
+    float    fValue = ePoint[c] + 0.f;
+    uint32_t iBits  = 0;
+    memcpy( &iBits, &fValue, sizeof( float ) );
+    iHash = ( iHash ^ iBits ) * 0xFF51AFD7ED558CCDull;
+    iHash ^= iHash >> 32;
+  }
+  return iHash;
+}
+
 void ObjectPointcloud::removeDuplicatePoints( int iDropDups ) {
-  if ( iDropDups == 0 ) { return; }
-  int    iNumDuplicate   = 0;
-  size_t iNumMultiColors = m_eRigParameters.getCount();
-  struct Coordinate {
-    int m_iIndex;
-    int m_iNumber;
+  if ( iDropDups == 0 || m_iNumPoints == 0 ) { return; }
+  // The points are dispatched in buckets by the high bits of the hash of their positions, then each bucket is processed
+  // by one thread with an open addressing table indexed by the low bits of the hash: the process is linear in the
+  // number of points. The points of a bucket are kept in index order: the first occurrence of each position is the
+  // same as in a sequential process. In average mode, the colors of the duplicate points are summed in integer
+  // accumulators and the rounded averages are stored in the first occurrences.
+  const size_t          iNumMultiColors = getNumMultiColors();
+  const size_t          iNumSum         = 4 + 3 * iNumMultiColors;
+  const int             iNumBuckets     = 256;
+  const int             iChunkSize      = 1 << 16;
+  const int             iNumChunks      = ( m_iNumPoints + iChunkSize - 1 ) / iChunkSize;
+  std::vector<int>      pFirst( m_iNumPoints ), pSorted( m_iNumPoints );
+  std::vector<int>      pOffset( iNumChunks * iNumBuckets, 0 ), pBucketStart( iNumBuckets + 1, 0 );
+  std::vector<uint64_t> pHash( m_iNumPoints );
+  runTasks( iNumChunks, [&]( int c ) {
+    for ( int i = c * iChunkSize; i < ( std::min )( m_iNumPoints, ( c + 1 ) * iChunkSize ); i++ ) {
+      pHash[i] = getPositionHash( m_pPoints[i] );
+      pOffset[c * iNumBuckets + ( pHash[i] >> 56 )]++;
+    }
+  } );
+  for ( int b = 0, iSum = 0; b < iNumBuckets; b++ ) {
+    pBucketStart[b] = iSum;
+    for ( int c = 0; c < iNumChunks; c++ ) {
+      int iCount                   = pOffset[c * iNumBuckets + b];
+      pOffset[c * iNumBuckets + b] = iSum;
+      iSum += iCount;
+    }
+    pBucketStart[b + 1] = iSum;
+  }
+  runTasks( iNumChunks, [&]( int c ) {
+    for ( int i = c * iChunkSize; i < ( std::min )( m_iNumPoints, ( c + 1 ) * iChunkSize ); i++ ) {
+      pSorted[pOffset[c * iNumBuckets + ( pHash[i] >> 56 )]++] = i;
+    }
+  } );
+  auto addColors = [&]( uint32_t* pSum, int i ) {
+    const Color4u8 eColor = m_bAlpha ? m_pColors4[i] : Color4u8( m_pColors3[i], 255 );
+    for ( int c = 0; c < 4; c++ ) { pSum[c] += eColor[c]; }
+    for ( size_t k = 0; k < iNumMultiColors; k++ ) {
+      for ( int c = 0; c < 3; c++ ) { pSum[4 + 3 * k + c] += m_pMultiColors3[i * iNumMultiColors + k][c]; }
+    }
   };
-  std::map<float, std::map<float, std::map<float, Coordinate>>> eMap;
-  for ( int i = 0; i < m_iNumPoints; i++ ) {
-    float x = m_pPoints[i][0], y = m_pPoints[i][1], z = m_pPoints[i][2];
-    if ( eMap.find( x ) != eMap.end() && eMap[x].find( y ) != eMap[x].end() &&
-         eMap[x][y].find( z ) != eMap[x][y].end() ) {
-      Coordinate& eCoordinate = eMap[x][y][z];
+  std::vector<int> pNumDuplicate( iNumBuckets, 0 );
+  runTasks( iNumBuckets, [&]( int b ) {
+    const int iSize     = pBucketStart[b + 1] - pBucketStart[b];
+    size_t    iCapacity = 16;
+    while ( iCapacity < 2 * static_cast<size_t>( iSize ) ) { iCapacity <<= 1; }
+    std::vector<int>      pSlot( iCapacity, -1 ), pSumIndex( iCapacity, -1 );
+    std::vector<int>      pNumber;
+    std::vector<uint32_t> pSum;
+    for ( int j = pBucketStart[b]; j < pBucketStart[b + 1]; j++ ) {
+      const int i = pSorted[j];
+      size_t    s = pHash[i] & ( iCapacity - 1 );
+      while ( pSlot[s] >= 0 && m_pPoints[pSlot[s]] != m_pPoints[i] ) { s = ( s + 1 ) & ( iCapacity - 1 ); }
+      if ( pSlot[s] < 0 ) {
+        pSlot[s]  = i;
+        pFirst[i] = i;
+        continue;
+      }
+      pFirst[i] = pSlot[s];
       if ( iDropDups == 2 ) {
-        if ( m_bAlpha ) {
-          m_pColors4[eCoordinate.m_iIndex] += m_pColors4[i];
-        } else {
-          m_pColors3[eCoordinate.m_iIndex] += m_pColors3[i];
-        }
-        if ( iNumMultiColors ) {
-          for ( size_t k = 0; k < iNumMultiColors; k++ ) {
-            m_pMultiColors3[eCoordinate.m_iIndex * iNumMultiColors + k] += m_pMultiColors3[i * iNumMultiColors + k];
-          }
+        if ( pSumIndex[s] < 0 ) {
+          pSumIndex[s] = static_cast<int>( pNumber.size() );
+          pNumber.push_back( 1 );
+          pSum.resize( pSum.size() + iNumSum, 0 );
+          addColors( pSum.data() + pSumIndex[s] * iNumSum, pSlot[s] );
         }
-        eCoordinate.m_iNumber++;
+        addColors( pSum.data() + pSumIndex[s] * iNumSum, i );
+        pNumber[pSumIndex[s]]++;
       }
-      iNumDuplicate++;
-    } else {
-      Coordinate eCoordinate;
-      eCoordinate.m_iIndex  = i;
-      eCoordinate.m_iNumber = 1;
-      eMap[x][y][z]         = eCoordinate;
+      pNumDuplicate[b]++;
     }
-  }
+    for ( size_t s = 0; s < iCapacity; s++ ) {
+      if ( pSumIndex[s] < 0 ) { continue; }
+      const int       i       = pSlot[s];
+      const uint32_t* pValues = pSum.data() + pSumIndex[s] * iNumSum;
+      const float     fNumber = static_cast<float>( pNumber[pSumIndex[s]] );
+      if ( m_bAlpha ) {
+        m_pColors4[i] = toColor8Bit( Color4( pValues[0], pValues[1], pValues[2], pValues[3] ) / fNumber );
+      } else {
+        m_pColors3[i] = toColor8Bit( Color3( pValues[0], pValues[1], pValues[2] ) / fNumber );
+      }
+      for ( size_t k = 0; k < iNumMultiColors; k++ ) {
+        m_pMultiColors3[i * iNumMultiColors + k] =
+            toColor8Bit( Color3( pValues[4 + 3 * k], pValues[5 + 3 * k], pValues[6 + 3 * k] ) / fNumber );
+      }
+    }
+  } );
+  int iNumDuplicate = 0;
+  for ( int b = 0; b < iNumBuckets; b++ ) { iNumDuplicate += pNumDuplicate[b]; }
 
   if ( iNumDuplicate > 0 ) {
-    std::vector<Point>   pNewPoints;
-    std::vector<Color3>  pNewColors3;
-    std::vector<Color4>  pNewColors4;
-    std::vector<Normal>  pNewNormals;
-    std::vector<uint8_t> pNewTypes;
-    std::vector<Color3>  pNewMultiColors3;
+    PointVector<Point>    pNewPoints;
+    PointVector<Color3u8> pNewColors3;
+    PointVector<Color4u8> pNewColors4;
+    PointVector<Normal>   pNewNormals;
+    PointVector<uint8_t>  pNewTypes;
+    PointVector<Color3u8> pNewMultiColors3;
+    std::vector<int>      pNewIndex( iNumChunks + 1, 0 );
     m_iNumDuplicate   = iNumDuplicate;
     int iNewNumPoints = m_iNumPoints - iNumDuplicate;
     pNewPoints.resize( iNewNumPoints );
@@ -416,23 +580,16 @@ void ObjectPointcloud::removeDuplicatePoints( int iDropDups ) {
     if ( m_bNormal ) { pNewNormals.resize( iNewNumPoints ); }
     if ( m_bType ) { pNewTypes.resize( iNewNumPoints ); }
     if ( iNumMultiColors ) { pNewMultiColors3.resize( iNewNumPoints * iNumMultiColors ); }
-    size_t iIndex = 0;
-    for ( int i = 0; i < m_iNumPoints; i++ ) {
-      float       x = m_pPoints[i][0], y = m_pPoints[i][1], z = m_pPoints[i][2];
-      Coordinate& eCoordinate = eMap[x][y][z];
-      if ( i == eCoordinate.m_iIndex ) {
-        if ( eCoordinate.m_iNumber > 1 ) {
-          if ( m_bAlpha ) {
-            m_pColors4[i] /= static_cast<float>( eCoordinate.m_iNumber );
-          } else {
-            m_pColors3[i] /= static_cast<float>( eCoordinate.m_iNumber );
-          }
-          if ( iNumMultiColors ) {
-            for ( size_t k = 0; k < iNumMultiColors; k++ ) {
-              m_pMultiColors3[i * iNumMultiColors + k] /= static_cast<float>( eCoordinate.m_iNumber );
-            }
-          }
-        }
+    runTasks( iNumChunks, [&]( int c ) {
+      for ( int i = c * iChunkSize; i < ( std::min )( m_iNumPoints, ( c + 1 ) * iChunkSize ); i++ ) {
+        pNewIndex[c + 1] += pFirst[i] == i ? 1 : 0;
+      }
+    } );
+    for ( int c = 0; c < iNumChunks; c++ ) { pNewIndex[c + 1] += pNewIndex[c]; }
+    runTasks( iNumChunks, [&]( int c ) {
+      size_t iIndex = pNewIndex[c];
+      for ( int i = c * iChunkSize; i < ( std::min )( m_iNumPoints, ( c + 1 ) * iChunkSize ); i++ ) {
+        if ( i != pFirst[i] ) { continue; }
         pNewPoints[iIndex] = m_pPoints[i];
         if ( m_bAlpha ) {
           pNewColors4[iIndex] = m_pColors4[i];
@@ -441,23 +598,12 @@ void ObjectPointcloud::removeDuplicatePoints( int iDropDups ) {
         }
         if ( m_bNormal ) { pNewNormals[iIndex] = m_pNormals[i]; }
         if ( m_bType ) { pNewTypes[iIndex] = m_pTypes[i]; }
-        if ( iNumMultiColors > 0 ) {
-          for ( size_t k = 0; k < iNumMultiColors; k++ ) {
-            pNewMultiColors3[iIndex * iNumMultiColors + k] = m_pMultiColors3[i * iNumMultiColors + k];
-          }
+        for ( size_t k = 0; k < iNumMultiColors; k++ ) {
+          pNewMultiColors3[iIndex * iNumMultiColors + k] = m_pMultiColors3[i * iNumMultiColors + k];
         }
         iIndex++;
       }
-    }
-    m_pPoints.clear();
-    if ( m_bAlpha ) {
-      m_pColors4.clear();
-    } else {
-      m_pColors3.clear();
-    }
-    if ( m_bNormal ) { m_pNormals.clear(); }
-    if ( m_bType ) { m_pTypes.clear(); }
-    if ( iNumMultiColors > 0 ) { m_pMultiColors3.clear(); }
+    } );
     m_pPoints.swap( pNewPoints );
     if ( m_bAlpha ) {
       m_pColors4.swap( pNewColors4 );
@@ -471,6 +617,99 @@ void ObjectPointcloud::removeDuplicatePoints( int iDropDups ) {
   }
 }
 
+//! Spread the 21 low bits of a value on one bit out of three of a Morton code.
+static inline uint64_t splitBy3( uint32_t iValue ) {
+  uint64_t x = iValue & 0x1FFFFF;
+  x          = ( x | x << 32 ) & 0x001F00000000FFFFull;
+  x          = ( x | x << 16 ) & 0x001F0000FF0000FFull;
+  x          = ( x | x << 8 ) & 0x100F00F00F00F00Full;
+  x          = ( x | x << 4 ) & 0x10C30C30C30C30C3ull;
+  x          = ( x | x << 2 ) & 0x1249249249249249ull;
+  return x;
+}
+
+//! Stable parallel LSD radix sort of the keys, the indices are moved with the keys.
+static void radixSort( std::vector<uint64_t>& pKeys, std::vector<int>& pIndex ) {
+  const int             iNumKeys   = static_cast<int>( pKeys.size() );
+  const int             iRadixBits = 11;
+  const int             iRadix     = 1 << iRadixBits;
+  const int             iChunkSize = 1 << 16;
+  const int             iNumChunks = ( iNumKeys + iChunkSize - 1 ) / iChunkSize;
+  std::vector<uint64_t> pNewKeys( iNumKeys );
+  std::vector<int>      pNewIndex( iNumKeys ), pOffset( iNumChunks * iRadix );
+  for ( int iShift = 0; iShift < 64; iShift += iRadixBits ) {
+    std::fill( pOffset.begin(), pOffset.end(), 0 );
+    runTasks( iNumChunks, [&]( int c ) {
+      for ( int i = c * iChunkSize; i < ( std::min )( iNumKeys, ( c + 1 ) * iChunkSize ); i++ ) {
+        pOffset[c * iRadix + ( ( pKeys[i] >> iShift ) & ( iRadix - 1 ) )]++;
+      }
+    } );
+    // The pass is skipped if all the keys have the same digit.
+    bool bSameDigit = false;
+    for ( int d = 0, iSum = 0; d < iRadix; d++ ) {
+      const int iStart = iSum;
+      for ( int c = 0; c < iNumChunks; c++ ) {
+        int iCount              = pOffset[c * iRadix + d];
+        pOffset[c * iRadix + d] = iSum;
+        iSum += iCount;
+      }
+      bSameDigit = bSameDigit || iSum - iStart == iNumKeys;
+    }
+    if ( bSameDigit ) { continue; }
+    runTasks( iNumChunks, [&]( int c ) {
+      for ( int i = c * iChunkSize; i < ( std::min )( iNumKeys, ( c + 1 ) * iChunkSize ); i++ ) {
+        const int j  = pOffset[c * iRadix + ( ( pKeys[i] >> iShift ) & ( iRadix - 1 ) )]++;
+        pNewKeys[j]  = pKeys[i];
+        pNewIndex[j] = pIndex[i];
+      }
+    } );
+    pKeys.swap( pNewKeys );
+    pIndex.swap( pNewIndex );
+  }
+}
+
+//! Reorder an array of iStride values per point.
+template <typename T>
+static void reorder( PointVector<T>& pValues, const std::vector<int>& pOrder, size_t iStride ) {
+  if ( pValues.empty() ) { return; }
+  PointVector<T> pNewValues( pValues.size() );
+  runChunkTasks( pOrder.size(), 1 << 16, [&]( size_t iBegin, size_t iEnd ) {
+    for ( size_t i = iBegin; i < iEnd; i++ ) {
+      for ( size_t k = 0; k < iStride; k++ ) { pNewValues[i * iStride + k] = pValues[pOrder[i] * iStride + k]; }
+    }
+  } );
+  pValues.swap( pNewValues );
+}
+
+void ObjectPointcloud::sortMortonOrder() {
+  m_bMortonOrder = true;
+  if ( m_iNumPoints < 2 ) { return; }
+  // The positions are quantized on 21 bits per axis with the same scale on the three axes.
+  const Vec3            eMin   = m_eBox.min();
+  const float           fSize  = m_eBox.getMaxSize();
+  const float           fScale = fSize > 0.f ? 2097151.f / fSize : 1.f;
+  std::vector<uint64_t> pKeys( m_iNumPoints );
+  std::vector<int>      pOrder( m_iNumPoints );
+  runChunkTasks( static_cast<size_t>( m_iNumPoints ), 1 << 16, [&]( size_t iBegin, size_t iEnd ) {
+    for ( size_t i = iBegin; i < iEnd; i++ ) {
+      uint64_t iKey = 0;
+      for ( int c = 0; c < 3; c++ ) {
+        const float fValue = CLIP( ( m_pPoints[i][c] - eMin[c] ) * fScale, 0.f, 2097151.f );
+        iKey |= splitBy3( static_cast<uint32_t>( fValue ) ) << c;
+      }
+      pKeys[i]  = iKey;
+      pOrder[i] = static_cast<int>( i );
+    }
+  } );
+  radixSort( pKeys, pOrder );
+  reorder( m_pPoints, pOrder, 1 );
+  reorder( m_pColors3, pOrder, 1 );
+  reorder( m_pColors4, pOrder, 1 );
+  reorder( m_pNormals, pOrder, 1 );
+  reorder( m_pTypes, pOrder, 1 );
+  reorder( m_pMultiColors3, pOrder, getNumMultiColors() );
+}
+
 void ObjectPointcloud::sortVertex(const Camera &cam) {
     m_bSort = true;
     std::vector<unsigned int> sorted_index;
@@ -479,7 +718,10 @@ void ObjectPointcloud::sortVertex(const Camera &cam) {
     point_distance.resize(m_iNumPoints);
     Vec3 pos, center, up, norm;
     cam.getLookAt(pos, center, up);
-    norm = glm::normalize(center - pos);
+    // The points are sorted in the space of the object: the model matrix is a positive scale and a translation.
+    const Mat4 inv = glm::inverse(m_eModel);
+    norm = glm::normalize(Vec3(inv * Vec4(center - pos, 0.f)));
+    pos  = Vec3(inv * Vec4(pos, 1.f));
 
     for (int i = 0; i < m_iNumPoints; i++) {
         sorted_index[i] = i;
@@ -498,116 +740,543 @@ void ObjectPointcloud::sortVertex(const Camera &cam) {
 
 void ObjectPointcloud::createBinaryDirectory( const std::string& sString ) { mkdir( sString.c_str(), 0777 ); }
 
-bool ObjectPointcloud::readBinary( const std::string& pString, int iFrameIndex ) {
-  bool          bError = false;
-  std::ifstream infile;
-  infile.open( pString.c_str(), std::ios::binary | std::ios::in );
-  if ( !infile || !infile.is_open() ) { return false; }
-  infile.seekg( 0, std::ifstream::end );
-  auto length = infile.tellg();
-  infile.seekg( 0, std::ifstream::beg );
-  float fXMin = 0.f, fXMax = 0.f, fYMin = 0.f, fYMax = 0.f, fZMin = 0.f, fZMax = 0.f;
-  infile.read( reinterpret_cast<char*>( &m_iNumPoints ), sizeof( uint32_t ) );
-  infile.read( reinterpret_cast<char*>( &m_iNumDuplicate ), sizeof( uint32_t ) );
-  infile.read( reinterpret_cast<char*>( &m_bAlpha ), sizeof( bool ) );
-  infile.read( reinterpret_cast<char*>( &m_bNormal ), sizeof( bool ) );
-  infile.read( reinterpret_cast<char*>( &m_bType ), sizeof( bool ) );
-  infile.read( reinterpret_cast<char*>( &fXMin ), sizeof( float ) );
-  infile.read( reinterpret_cast<char*>( &fXMax ), sizeof( float ) );
-  infile.read( reinterpret_cast<char*>( &fYMin ), sizeof( float ) );
-  infile.read( reinterpret_cast<char*>( &fYMax ), sizeof( float ) );
-  infile.read( reinterpret_cast<char*>( &fZMin ), sizeof( float ) );
-  infile.read( reinterpret_cast<char*>( &fZMax ), sizeof( float ) );
-  uint32_t iCountMultiColors = 0;
-  infile.read( reinterpret_cast<char*>( &iCountMultiColors ), sizeof( uint32_t ) );
-  if ( bError || iCountMultiColors > 255 ) {
-    reset();
-    printf( "PLYREADER: Error in binary file reading process. \n" );
-    fflush( stdout );
-    infile.close();
-    std::remove( pString.c_str() );
+// Header of the binary cache files. The sections follow the header and the name of the source file, each section
+// starts on a 64-byte boundary so the arrays can be used directly from a mapping of the file.
+struct BinaryHeader {
+  char     m_pMagic[4];
+  uint32_t m_iVersion;
+  uint32_t m_iNumPoints;
+  uint32_t m_iNumDuplicate;
+  int32_t  m_iDropDups;
+  uint32_t m_iCountMultiColors;
+  uint8_t  m_bAlpha;
+  uint8_t  m_bNormal;
+  uint8_t  m_bType;
+  uint8_t  m_iPositionFormat;  // 0: float32, 1: uint16 voxel indices, position = box.min + index * scale
+  uint8_t  m_iColorFormat;     // 1: uint8, the colors are stored as in memory
+  uint8_t  m_iPointOrder;      // 0: order of the source file, 1: Morton order
+  uint8_t  m_iPositionBits;    // 0: lossless, otherwise quantization bits requested by the writer
+  uint8_t  m_pReserved[1];
+  uint32_t m_iSourceLength;
+  float    m_fScale;
+  uint64_t m_iSourceSize;
+  int64_t  m_iSourceTime;
+  float    m_pBox[6];
+  uint64_t m_pOffset[7];  // points, colors, normals, types, rig parameters, multi-colors, end of file
+};
+static_assert( sizeof( BinaryHeader ) == 136, "BinaryHeader must have a fixed layout" );
+
+static const char     g_pBinaryMagic[4] = {'P', 'C', 'B', 'C'};
+static const uint32_t g_iBinaryVersion  = 1;
+static const size_t   g_iBinaryAlign    = 64;
+
+//! True if fValue is restored bit exact from its integer value: -0 is an integer but it would be restored as +0.
+static inline bool isIntegerValue( float fValue ) {
+  return std::floor( fValue ) == fValue && ( fValue != 0.f || !std::signbit( fValue ) );
+}
+
+static inline uint64_t alignOffset( uint64_t iOffset ) {
+  return ( iOffset + g_iBinaryAlign - 1 ) / g_iBinaryAlign * g_iBinaryAlign;
+}
+
+bool ObjectPointcloud::readBinary( const std::string& pString, int iFrameIndex, int iDropDups ) {
+  MemoryMap eMemoryMap;
+  Prefetcher::getInstance().wait( pString );
+  if ( !eMemoryMap.open( pString ) ) { return false; }
+  if ( !decodeBinary( eMemoryMap.data(), eMemoryMap.size(), iFrameIndex, iDropDups ) ) {
+    printf( "PLYREADER: binary file %s is not valid or out of date and will be recreated. \n", pString.c_str() );
+    return false;
+  }
+  return true;
+}
+
+bool ObjectPointcloud::readContainer( const SequenceContainer& eContainer, size_t iFrame ) {
+  const auto& eFrame = eContainer.getFrame( iFrame );
+  m_eFilename        = stringFormat( "%s:%d", eContainer.getFilename().c_str(), eFrame.m_iFrameIndex );
+  Prefetcher::getInstance().wait( eContainer.getFilename(), eFrame.m_iOffset );
+  if ( !decodeBinary( eContainer.getFrameData( iFrame ), eFrame.m_iSize, eFrame.m_iFrameIndex, -1 ) ) {
+    printf( "PLYREADER: frame %zu of %s is not valid. \n", iFrame, eContainer.getFilename().c_str() );
     return false;
   }
-  m_eRigParameters.setCount( iCountMultiColors );
-  allocate( m_bAlpha, m_bNormal, m_bType, m_iNumPoints, iFrameIndex, m_iNumDuplicate );
-  setBox( fXMin, fXMax, fYMin, fYMax, fZMin, fZMax );
-  infile.read( reinterpret_cast<char*>( getPoints() ), m_iNumPoints * sizeof( float ) * 3 );
-  infile.read( static_cast<char*>( getColors() ), m_iNumPoints * sizeof( float ) * ( 3 + m_bAlpha ) );
-  if ( m_bNormal ) { infile.read( reinterpret_cast<char*>( getNormals() ), m_iNumPoints * sizeof( float ) * 3 ); }
-  if ( m_bType ) { infile.read( reinterpret_cast<char*>( getTypes() ), m_iNumPoints * sizeof( uint8_t ) ); }
-
-  if ( iCountMultiColors > 0 ) {
-    float scale, width;
-    Vec3  translation;
-    infile.read( reinterpret_cast<char*>( &scale ), sizeof( float ) );
-    infile.read( reinterpret_cast<char*>( &translation.x ), sizeof( float ) * 3 );
-    infile.read( reinterpret_cast<char*>( &width ), sizeof( float ) );
-    m_eRigParameters.setFrameToWorldTranslation( translation );
-    m_eRigParameters.setFrameToWorldScale( scale );
-    m_eRigParameters.setWidth( width );
-    for ( size_t i = 0; i < iCountMultiColors; i++ ) {
-      infile.read( reinterpret_cast<char*>( &m_eRigParameters.getMatrix( i ) ), sizeof( float ) * 16 );
+  return true;
+}
+
+bool ObjectPointcloud::decodeBinary( const uint8_t* pData, size_t iSize, int iFrameIndex, int iDropDups ) {
+  BinaryHeader eHeader;
+  if ( iSize < sizeof( BinaryHeader ) ) { return false; }
+  memcpy( &eHeader, pData, sizeof( BinaryHeader ) );
+  if ( memcmp( eHeader.m_pMagic, g_pBinaryMagic, sizeof( g_pBinaryMagic ) ) != 0 ||
+       eHeader.m_iVersion != g_iBinaryVersion || eHeader.m_pOffset[6] != iSize ||
+       sizeof( BinaryHeader ) + eHeader.m_iSourceLength > iSize || eHeader.m_iCountMultiColors > 255 ||
+       eHeader.m_iColorFormat != 1 ) {
+    return false;
+  }
+  // The cache is only used if it has been created from the current version of the source file. The frames of the
+  // sequence containers (iDropDups < 0) are used as they are. The entries of a cache directory are named by the
+  // fingerprint of their source: they are shared by the copies of the source, only its name is not checked.
+  if ( iDropDups >= 0 ) {
+    uint64_t    iSourceSize = 0;
+    int64_t     iSourceTime = 0;
+    std::string sSource( reinterpret_cast<const char*>( pData ) + sizeof( BinaryHeader ), eHeader.m_iSourceLength );
+    const bool  bShared = CacheDirectory::getInstance().isEnabled();
+    if ( ( !bShared && sSource != m_eFilename ) || eHeader.m_iDropDups != iDropDups ||
+         !getFileStatus( m_eFilename, iSourceSize, iSourceTime ) || eHeader.m_iSourceSize != iSourceSize ||
+         eHeader.m_iSourceTime != iSourceTime ) {
+      return false;
     }
-    infile.read( reinterpret_cast<char*>( m_pMultiColors3.data() ),
-                 m_iNumPoints * iCountMultiColors * sizeof( float ) * 3 );
   }
-  if ( length != infile.tellg() ) {
-    bError = true;
-    printf( "error file have not a correct size  \n" );
+  const size_t iNumPoints = eHeader.m_iNumPoints;
+  const size_t iCount     = eHeader.m_iCountMultiColors;
+  const size_t pSize[6]   = {iNumPoints * ( eHeader.m_iPositionFormat ? sizeof( uint16_t ) : sizeof( float ) ) * 3,
+                           iNumPoints * sizeof( uint8_t ) * ( 3 + eHeader.m_bAlpha ),
+                           eHeader.m_bNormal ? iNumPoints * sizeof( Normal ) : 0,
+                           eHeader.m_bType ? iNumPoints * sizeof( uint8_t ) : 0,
+                           iCount > 0 ? sizeof( float ) * ( 5 + 16 * iCount ) : 0,
+                           iNumPoints * iCount * sizeof( Color3u8 )};
+  for ( size_t i = 0; i < 6; i++ ) {
+    if ( eHeader.m_pOffset[i] % g_iBinaryAlign != 0 || eHeader.m_pOffset[i] + pSize[i] > iSize ) { return false; }
   }
-  if ( !infile ) { bError = true; }
-  if ( bError ) {
-    reset();
-    printf( "PLYREADER: Error in binary file reading process. \n" );
-    infile.close();
-    std::remove( pString.c_str() );
-    return false;
+  m_eRigParameters.setCount( iCount );
+  allocate( eHeader.m_bAlpha, eHeader.m_bNormal, eHeader.m_bType, eHeader.m_iNumPoints, iFrameIndex,
+            eHeader.m_iNumDuplicate );
+  setBox( eHeader.m_pBox[0], eHeader.m_pBox[3], eHeader.m_pBox[1], eHeader.m_pBox[4], eHeader.m_pBox[2],
+          eHeader.m_pBox[5] );
+  if ( eHeader.m_iPositionFormat ) {
+    const uint16_t* pPosition = reinterpret_cast<const uint16_t*>( pData + eHeader.m_pOffset[0] );
+    const Vec3      eOrigin( eHeader.m_pBox[0], eHeader.m_pBox[1], eHeader.m_pBox[2] );
+    const float     fScale = eHeader.m_fScale;
+    runChunkTasks( iNumPoints, 1 << 16, [&]( size_t iBegin, size_t iEnd ) {
+      for ( size_t i = iBegin; i < iEnd; i++ ) {
+        m_pPoints[i] = eOrigin + Vec3( pPosition[3 * i + 0], pPosition[3 * i + 1], pPosition[3 * i + 2] ) * fScale;
+      }
+    } );
+  } else {
+    memcpy( getPoints(), pData + eHeader.m_pOffset[0], pSize[0] );
+  }
+  memcpy( getColors(), pData + eHeader.m_pOffset[1], pSize[1] );
+  if ( m_bNormal ) { memcpy( getNormals(), pData + eHeader.m_pOffset[2], pSize[2] ); }
+  if ( m_bType ) { memcpy( getTypes(), pData + eHeader.m_pOffset[3], pSize[3] ); }
+  m_bMortonOrder  = eHeader.m_iPointOrder == 1;
+  m_iPositionBits = eHeader.m_iPositionBits;
+  if ( iCount > 0 ) {
+    const float* pRig = reinterpret_cast<const float*>( pData + eHeader.m_pOffset[4] );
+    m_eRigParameters.setFrameToWorldScale( pRig[0] );
+    m_eRigParameters.setFrameToWorldTranslation( Vec3( pRig[1], pRig[2], pRig[3] ) );
+    m_eRigParameters.setWidth( pRig[4] );
+    for ( size_t i = 0; i < iCount; i++ ) { m_eRigParameters.getMatrix( i ) = glm::make_mat4( pRig + 5 + 16 * i ); }
+    if ( m_bMultiColor ) { memcpy( m_pMultiColors3.data(), pData + eHeader.m_pOffset[5], pSize[5] ); }
+  }
+  m_iIndex = m_iNumPoints;
+  return true;
+}
+
+void ObjectPointcloud::writeBinary( const std::string& filename, int iDropDups ) {
+  std::vector<uint8_t> pBuffer;
+  encodeBinary( pBuffer, iDropDups );
+  CacheWriter::getInstance().push( filename, std::move( pBuffer ) );
+}
+
+void ObjectPointcloud::encodeBinary( std::vector<uint8_t>& pBuffer, int iDropDups ) {
+  BinaryHeader eHeader;
+  memset( &eHeader, 0, sizeof( BinaryHeader ) );
+  memcpy( eHeader.m_pMagic, g_pBinaryMagic, sizeof( g_pBinaryMagic ) );
+  getFileStatus( m_eFilename, eHeader.m_iSourceSize, eHeader.m_iSourceTime );
+  const size_t iNumPoints     = static_cast<size_t>( m_iNumPoints );
+  const size_t iCount         = m_eRigParameters.getCount();
+  const size_t iNumColors     = iNumPoints * ( 3 + m_bAlpha );
+  eHeader.m_iVersion          = g_iBinaryVersion;
+  eHeader.m_iNumPoints        = static_cast<uint32_t>( m_iNumPoints );
+  eHeader.m_iNumDuplicate     = static_cast<uint32_t>( m_iNumDuplicate );
+  eHeader.m_iDropDups         = iDropDups;
+  eHeader.m_iCountMultiColors = static_cast<uint32_t>( iCount );
+  eHeader.m_bAlpha            = m_bAlpha;
+  eHeader.m_bNormal           = m_bNormal;
+  eHeader.m_bType             = m_bType;
+  eHeader.m_iPointOrder       = m_bMortonOrder;
+  eHeader.m_iSourceLength     = static_cast<uint32_t>( m_eFilename.size() );
+  eHeader.m_fScale            = 1.f;
+  for ( int i = 0; i < 3; i++ ) {
+    eHeader.m_pBox[i]     = m_eBox.min()[i];
+    eHeader.m_pBox[i + 3] = m_eBox.max()[i];
+  }
+  // The positions are stored as uint16 if they are on an integer grid of at most 16 bits, as the voxelized contents.
+  bool bVoxelized = iNumPoints > 0;
+  for ( int i = 0; i < 3; i++ ) {
+    bVoxelized = bVoxelized && std::floor( m_eBox.min()[i] ) == m_eBox.min()[i] &&
+                 m_eBox.max()[i] - m_eBox.min()[i] <= 65535.f;
+  }
+  if ( bVoxelized ) {
+    const size_t         iChunkSize = 1 << 16;
+    const int            iNumChunks = static_cast<int>( ( iNumPoints + iChunkSize - 1 ) / iChunkSize );
+    std::vector<uint8_t> pInteger( iNumChunks, 1 );
+    runTasks( iNumChunks, [&]( int c ) {
+      for ( size_t i = c * iChunkSize; i < ( std::min )( iNumPoints, ( c + 1 ) * iChunkSize ) && pInteger[c]; i++ ) {
+        const Point& ePoint = m_pPoints[i];
+        pInteger[c] = isIntegerValue( ePoint[0] ) && isIntegerValue( ePoint[1] ) && isIntegerValue( ePoint[2] );
+      }
+    } );
+    bVoxelized = std::find( pInteger.begin(), pInteger.end(), 0 ) == pInteger.end();
+  }
+  // The other contents are quantized if requested: the positions are the indices of a regular grid of the bounding
+  // box with m_iQuantization bits per coordinate.
+  const bool bQuantized = !bVoxelized && iNumPoints > 0 && m_iQuantization > 0;
+  if ( bQuantized ) {
+    const float fSize = m_eBox.getMaxSize() / static_cast<float>( ( 1 << m_iQuantization ) - 1 );
+    eHeader.m_fScale  = fSize > 0.f ? fSize : 1.f;
+  }
+  eHeader.m_iPositionBits   = m_iQuantization;
+  eHeader.m_iPositionFormat = bVoxelized || bQuantized;
+  eHeader.m_iColorFormat    = 1;
+  const size_t pSize[6]     = {iNumPoints * ( eHeader.m_iPositionFormat ? sizeof( uint16_t ) : sizeof( float ) ) * 3,
+                           iNumColors * sizeof( uint8_t ),
+                           m_bNormal ? iNumPoints * sizeof( Normal ) : 0,
+                           m_bType ? iNumPoints * sizeof( uint8_t ) : 0,
+                           iCount > 0 ? sizeof( float ) * ( 5 + 16 * iCount ) : 0,
+                           iNumPoints * iCount * sizeof( Color3u8 )};
+  uint64_t iOffset = sizeof( BinaryHeader ) + eHeader.m_iSourceLength;
+  for ( size_t i = 0; i < 6; i++ ) {
+    eHeader.m_pOffset[i] = alignOffset( iOffset );
+    iOffset              = eHeader.m_pOffset[i] + pSize[i];
+  }
+  eHeader.m_pOffset[6] = iOffset;
+
+  // The frame is serialized here because the points can be modified after the read, the write is done in background.
+  pBuffer.assign( iOffset, 0 );
+  uint8_t* pData = pBuffer.data();
+  memcpy( pData, &eHeader, sizeof( BinaryHeader ) );
+  memcpy( pData + sizeof( BinaryHeader ), m_eFilename.data(), m_eFilename.size() );
+  if ( bVoxelized ) {
+    uint16_t*  pPosition = reinterpret_cast<uint16_t*>( pData + eHeader.m_pOffset[0] );
+    const Vec3 eOrigin   = m_eBox.min();
+    runChunkTasks( iNumPoints, 1 << 16, [&]( size_t iBegin, size_t iEnd ) {
+      for ( size_t i = iBegin; i < iEnd; i++ ) {
+        for ( int c = 0; c < 3; c++ ) { pPosition[3 * i + c] = static_cast<uint16_t>( m_pPoints[i][c] - eOrigin[c] ); }
+      }
+    } );
+  } else if ( bQuantized ) {
+    uint16_t*   pPosition = reinterpret_cast<uint16_t*>( pData + eHeader.m_pOffset[0] );
+    const Vec3  eOrigin   = m_eBox.min();
+    const float fInverse  = 1.f / eHeader.m_fScale;
+    runChunkTasks( iNumPoints, 1 << 16, [&]( size_t iBegin, size_t iEnd ) {
+      for ( size_t i = iBegin; i < iEnd; i++ ) {
+        for ( int c = 0; c < 3; c++ ) {
+          pPosition[3 * i + c] = static_cast<uint16_t>( ( m_pPoints[i][c] - eOrigin[c] ) * fInverse + 0.5f );
+        }
+      }
+    } );
+  } else {
+    memcpy( pData + eHeader.m_pOffset[0], getPoints(), pSize[0] );
+  }
+  memcpy( pData + eHeader.m_pOffset[1], getColors(), pSize[1] );
+  if ( m_bNormal ) { memcpy( pData + eHeader.m_pOffset[2], getNormals(), pSize[2] ); }
+  if ( m_bType ) { memcpy( pData + eHeader.m_pOffset[3], getTypes(), pSize[3] ); }
+  if ( iCount > 0 ) {
+    float* pRig = reinterpret_cast<float*>( pData + eHeader.m_pOffset[4] );
+    Vec3   vec  = m_eRigParameters.getFrameToWorldTranslation();
+    pRig[0]     = m_eRigParameters.getFrameToWorldScale();
+    pRig[1]     = vec[0];
+    pRig[2]     = vec[1];
+    pRig[3]     = vec[2];
+    pRig[4]     = m_eRigParameters.getWidth();
+    for ( size_t i = 0; i < iCount; i++ ) {
+      memcpy( pRig + 5 + 16 * i, glm::value_ptr( m_eRigParameters.getMatrix( i ) ), sizeof( float ) * 16 );
+    }
+    memcpy( pData + eHeader.m_pOffset[5], m_pMultiColors3.data(), pSize[5] );
+  }
+}
+
+// Frames compressed in memory: the points are cut in chunks coded independently, so the chunks are coded and decoded
+// by parallel tasks. In a chunk, the positions are delta coded variable length integers in the order of the points
+// (the Morton order gives the smallest deltas), the colors, types and multi-colors are delta coded byte planes and the
+// normals are copied. The chunks are then compressed by zstd if the renderer is built with it.
+struct CompressedHeader {
+  uint32_t m_iNumPoints;
+  uint32_t m_iNumDuplicate;
+  uint32_t m_iNumChunks;
+  uint32_t m_iCountMultiColors;
+  uint8_t  m_bAlpha;
+  uint8_t  m_bNormal;
+  uint8_t  m_bType;
+  uint8_t  m_bMultiColor;
+  uint8_t  m_bZstd;
+  uint8_t  m_iSkippedAttributes;
+  uint8_t  m_bMortonOrder;
+  uint8_t  m_iPositionBits;
+};
+
+static const size_t g_iCompressedChunkSize = 1 << 16;
+
+static inline void putVarint( uint8_t*& pOut, uint32_t iValue ) {
+  while ( iValue >= 0x80 ) {
+    *pOut++ = static_cast<uint8_t>( iValue | 0x80 );
+    iValue >>= 7;
+  }
+  *pOut++ = static_cast<uint8_t>( iValue );
+}
+
+static inline bool getVarint( const uint8_t*& pIn, const uint8_t* pEnd, uint32_t& iValue ) {
+  iValue = 0;
+  for ( int iShift = 0; iShift < 35 && pIn < pEnd; iShift += 7 ) {
+    const uint8_t iByte = *pIn++;
+    iValue |= static_cast<uint32_t>( iByte & 0x7f ) << iShift;
+    if ( ( iByte & 0x80 ) == 0 ) { return true; }
+  }
+  return false;
+}
+
+static inline uint32_t zigzag( int32_t iValue ) {
+  return ( static_cast<uint32_t>( iValue ) << 1 ) ^ static_cast<uint32_t>( iValue >> 31 );
+}
+static inline int32_t unzigzag( uint32_t iValue ) {
+  return static_cast<int32_t>( iValue >> 1 ) ^ -static_cast<int32_t>( iValue & 1 );
+}
+
+static void encodePlanes( const uint8_t* pData, size_t iNumChannels, size_t iNumPoints, uint8_t*& pOut ) {
+  for ( size_t c = 0; c < iNumChannels; c++ ) {
+    uint8_t iPrevious = 0;
+    for ( size_t i = 0; i < iNumPoints; i++ ) {
+      const uint8_t iValue = pData[i * iNumChannels + c];
+      *pOut++              = static_cast<uint8_t>( iValue - iPrevious );
+      iPrevious            = iValue;
+    }
+  }
+}
+
+static bool decodePlanes( const uint8_t*& pIn, const uint8_t* pEnd, uint8_t* pData, size_t iNumChannels,
+                          size_t iNumPoints ) {
+  if ( static_cast<size_t>( pEnd - pIn ) < iNumChannels * iNumPoints ) { return false; }
+  for ( size_t c = 0; c < iNumChannels; c++ ) {
+    uint8_t iPrevious = 0;
+    for ( size_t i = 0; i < iNumPoints; i++ ) {
+      iPrevious                   = static_cast<uint8_t>( iPrevious + *pIn++ );
+      pData[i * iNumChannels + c] = iPrevious;
+    }
   }
-  infile.close();
   return true;
 }
 
-void ObjectPointcloud::writeBinary( const std::string& filename ) {
-  std::ofstream outfile;
-  std::string   directory = getDirectory( filename );
-  if ( !dirExists( directory ) ) { createBinaryDirectory( directory ); }
-  outfile.open( filename.c_str(), std::ios::binary | std::ios::out );
-  float fXMin = m_eBox.min()[0], fYMin = m_eBox.min()[1], fZMin = m_eBox.min()[2];
-  float fXMax = m_eBox.max()[0], fYMax = m_eBox.max()[1], fZMax = m_eBox.max()[2];
-  outfile.write( reinterpret_cast<char*>( &m_iNumPoints ), sizeof( uint32_t ) );
-  outfile.write( reinterpret_cast<char*>( &m_iNumDuplicate ), sizeof( uint32_t ) );
-  outfile.write( reinterpret_cast<char*>( &m_bAlpha ), sizeof( bool ) );
-  outfile.write( reinterpret_cast<char*>( &m_bNormal ), sizeof( bool ) );
-  outfile.write( reinterpret_cast<char*>( &m_bType ), sizeof( bool ) );
-  outfile.write( reinterpret_cast<char*>( &fXMin ), sizeof( float ) );
-  outfile.write( reinterpret_cast<char*>( &fXMax ), sizeof( float ) );
-  outfile.write( reinterpret_cast<char*>( &fYMin ), sizeof( float ) );
-  outfile.write( reinterpret_cast<char*>( &fYMax ), sizeof( float ) );
-  outfile.write( reinterpret_cast<char*>( &fZMin ), sizeof( float ) );
-  outfile.write( reinterpret_cast<char*>( &fZMax ), sizeof( float ) );
-  auto iCountMultiColors = static_cast<uint32_t>( m_eRigParameters.getCount() );
-  outfile.write( reinterpret_cast<char*>( &iCountMultiColors ), sizeof( uint32_t ) );
-  outfile.write( reinterpret_cast<char*>( getPoints() ), m_iNumPoints * sizeof( float ) * 3 );
-  outfile.write( static_cast<char*>( getColors() ), m_iNumPoints * sizeof( float ) * ( 3 + m_bAlpha ) );
-  if ( m_bNormal ) { outfile.write( reinterpret_cast<char*>( getNormals() ), m_iNumPoints * sizeof( float ) * 3 ); }
-  if ( m_bType ) { outfile.write( reinterpret_cast<char*>( getTypes() ), m_iNumPoints * sizeof( uint8_t ) ); }
-  if ( iCountMultiColors > 0 ) {
-    float scale = m_eRigParameters.getFrameToWorldScale();
-    auto  vec   = m_eRigParameters.getFrameToWorldTranslation();
-    float width = m_eRigParameters.getWidth();
-    outfile.write( reinterpret_cast<char*>( &scale ), sizeof( float ) );
-    outfile.write( reinterpret_cast<char*>( &vec ), sizeof( float ) * 3 );
-    outfile.write( reinterpret_cast<char*>( &width ), sizeof( float ) );
-    for ( size_t i = 0; i < iCountMultiColors; i++ ) {
-      outfile.write( reinterpret_cast<char*>( &( m_eRigParameters.getMatrix( i ) ) ), sizeof( float ) * 16 );
+void ObjectPointcloud::compress( std::vector<uint8_t>& pBuffer ) {
+  const size_t     iNumPoints = static_cast<size_t>( m_iNumPoints );
+  const size_t     iCount     = m_eRigParameters.getCount();
+  const size_t     iNumColors = 3 + m_bAlpha;
+  const size_t     iNumMulti  = m_bMultiColor ? 3 * iCount : 0;
+  const size_t     iNumChunks = ( iNumPoints + g_iCompressedChunkSize - 1 ) / g_iCompressedChunkSize;
+  const uint8_t*   pColors    = reinterpret_cast<const uint8_t*>( getColors() );
+  CompressedHeader eHeader;
+  memset( &eHeader, 0, sizeof( CompressedHeader ) );
+  eHeader.m_iNumPoints         = static_cast<uint32_t>( m_iNumPoints );
+  eHeader.m_iNumDuplicate      = static_cast<uint32_t>( m_iNumDuplicate );
+  eHeader.m_iNumChunks         = static_cast<uint32_t>( iNumChunks );
+  eHeader.m_iCountMultiColors  = static_cast<uint32_t>( iCount );
+  eHeader.m_bAlpha             = m_bAlpha;
+  eHeader.m_bNormal            = m_bNormal;
+  eHeader.m_bType              = m_bType;
+  eHeader.m_bMultiColor        = m_bMultiColor;
+  eHeader.m_iSkippedAttributes = m_iSkippedAttributes;
+  eHeader.m_bMortonOrder       = m_bMortonOrder;
+  eHeader.m_iPositionBits      = m_iPositionBits;
+#ifdef USE_ZSTD
+  eHeader.m_bZstd = 1;
+#endif
+  std::vector<std::vector<uint8_t>> pChunks( iNumChunks );
+  runTasks( static_cast<int>( iNumChunks ), [&]( int c ) {
+    const size_t iBegin = c * g_iCompressedChunkSize;
+    const size_t iSize  = ( std::min )( iNumPoints, iBegin + g_iCompressedChunkSize ) - iBegin;
+    // The positions on an integer grid, as the voxelized contents, are coded by their deltas, the other positions by
+    // the deltas of the bits of the floats.
+    bool bInteger = true;
+    for ( size_t i = iBegin; i < iBegin + iSize && bInteger; i++ ) {
+      for ( int k = 0; k < 3; k++ ) {
+        const float fValue = m_pPoints[i][k];
+        bInteger           = bInteger && isIntegerValue( fValue ) && std::fabs( fValue ) < 1073741824.f;
+      }
+    }
+    std::vector<uint8_t> pRaw( 1 + iSize * ( 15 + iNumColors + m_bType + ( m_bNormal ? sizeof( Normal ) : 0 ) +
+                                             iNumMulti ) );
+    uint8_t* pOut         = pRaw.data();
+    int32_t  pPrevious[3] = {0, 0, 0};
+    *pOut++               = bInteger;
+    for ( size_t i = iBegin; i < iBegin + iSize; i++ ) {
+      for ( int k = 0; k < 3; k++ ) {
+        int32_t iValue = 0;
+        if ( bInteger ) {
+          iValue = static_cast<int32_t>( m_pPoints[i][k] );
+        } else {
+          memcpy( &iValue, &m_pPoints[i][k], sizeof( int32_t ) );
+        }
+        putVarint( pOut, zigzag( static_cast<int32_t>( static_cast<uint32_t>( iValue ) -
+                                                       static_cast<uint32_t>( pPrevious[k] ) ) ) );
+        pPrevious[k] = iValue;
+      }
+    }
+    encodePlanes( pColors + iBegin * iNumColors, iNumColors, iSize, pOut );
+    if ( m_bType ) { encodePlanes( m_pTypes.data() + iBegin, 1, iSize, pOut ); }
+    if ( m_bNormal ) {
+      memcpy( pOut, m_pNormals.data() + iBegin, iSize * sizeof( Normal ) );
+      pOut += iSize * sizeof( Normal );
+    }
+    if ( iNumMulti > 0 ) {
+      encodePlanes( reinterpret_cast<const uint8_t*>( m_pMultiColors3.data() ) + iBegin * iNumMulti, iNumMulti, iSize,
+                    pOut );
+    }
+    pRaw.resize( pOut - pRaw.data() );
+#ifdef USE_ZSTD
+    // Each chunk starts by the size of its raw data.
+    const uint64_t iRawSize = pRaw.size();
+    pChunks[c].resize( sizeof( uint64_t ) + ZSTD_compressBound( pRaw.size() ) );
+    memcpy( pChunks[c].data(), &iRawSize, sizeof( uint64_t ) );
+    const size_t iResult = ZSTD_compress( pChunks[c].data() + sizeof( uint64_t ),
+                                          pChunks[c].size() - sizeof( uint64_t ), pRaw.data(), pRaw.size(), 1 );
+    pChunks[c].resize( ZSTD_isError( iResult ) ? 0 : sizeof( uint64_t ) + iResult );
+#else
+    pChunks[c].swap( pRaw );
+#endif
+  } );
+  // Header, rig parameters, sizes of the chunks and chunks.
+  const size_t iRigSize = iCount > 0 ? sizeof( float ) * ( 5 + 16 * iCount ) : 0;
+  size_t       iOffset  = sizeof( CompressedHeader ) + iRigSize + iNumChunks * sizeof( uint64_t );
+  for ( auto& pChunk : pChunks ) { iOffset += pChunk.size(); }
+  pBuffer.resize( iOffset );
+  uint8_t* pData = pBuffer.data();
+  memcpy( pData, &eHeader, sizeof( CompressedHeader ) );
+  pData += sizeof( CompressedHeader );
+  if ( iCount > 0 ) {
+    float* pRig = reinterpret_cast<float*>( pData );
+    Vec3   vec  = m_eRigParameters.getFrameToWorldTranslation();
+    pRig[0]     = m_eRigParameters.getFrameToWorldScale();
+    pRig[1]     = vec[0];
+    pRig[2]     = vec[1];
+    pRig[3]     = vec[2];
+    pRig[4]     = m_eRigParameters.getWidth();
+    for ( size_t i = 0; i < iCount; i++ ) {
+      memcpy( pRig + 5 + 16 * i, glm::value_ptr( m_eRigParameters.getMatrix( i ) ), sizeof( float ) * 16 );
+    }
+    pData += iRigSize;
+  }
+  for ( auto& pChunk : pChunks ) {
+    const uint64_t iSize = pChunk.size();
+    memcpy( pData, &iSize, sizeof( uint64_t ) );
+    pData += sizeof( uint64_t );
+  }
+  for ( auto& pChunk : pChunks ) {
+    if ( !pChunk.empty() ) { memcpy( pData, pChunk.data(), pChunk.size() ); }
+    pData += pChunk.size();
+  }
+}
+
+bool ObjectPointcloud::decompress( const std::vector<uint8_t>& pBuffer ) {
+  CompressedHeader eHeader;
+  if ( pBuffer.size() < sizeof( CompressedHeader ) ) { return false; }
+  memcpy( &eHeader, pBuffer.data(), sizeof( CompressedHeader ) );
+  const size_t   iNumPoints = eHeader.m_iNumPoints;
+  const size_t   iCount     = eHeader.m_iCountMultiColors;
+  const size_t   iNumChunks = eHeader.m_iNumChunks;
+  const size_t   iNumColors = 3 + eHeader.m_bAlpha;
+  const size_t   iNumMulti  = eHeader.m_bMultiColor ? 3 * iCount : 0;
+  const size_t   iRigSize   = iCount > 0 ? sizeof( float ) * ( 5 + 16 * iCount ) : 0;
+  const uint8_t* pData      = pBuffer.data() + sizeof( CompressedHeader );
+  const uint8_t* pEnd       = pBuffer.data() + pBuffer.size();
+#ifndef USE_ZSTD
+  if ( eHeader.m_bZstd ) { return false; }
+#endif
+  if ( iNumChunks != ( iNumPoints + g_iCompressedChunkSize - 1 ) / g_iCompressedChunkSize ||
+       static_cast<size_t>( pEnd - pData ) < iRigSize + iNumChunks * sizeof( uint64_t ) ) {
+    return false;
+  }
+  m_eRigParameters.setCount( iCount );
+  if ( iCount > 0 ) {
+    const float* pRig = reinterpret_cast<const float*>( pData );
+    m_eRigParameters.setFrameToWorldScale( pRig[0] );
+    m_eRigParameters.setFrameToWorldTranslation( Vec3( pRig[1], pRig[2], pRig[3] ) );
+    m_eRigParameters.setWidth( pRig[4] );
+    for ( size_t i = 0; i < iCount; i++ ) { m_eRigParameters.getMatrix( i ) = glm::make_mat4( pRig + 5 + 16 * i ); }
+    pData += iRigSize;
+  }
+  std::vector<const uint8_t*> pChunkData( iNumChunks + 1 );
+  pChunkData[0] = pData + iNumChunks * sizeof( uint64_t );
+  for ( size_t c = 0; c < iNumChunks; c++ ) {
+    uint64_t iSize = 0;
+    memcpy( &iSize, pData + c * sizeof( uint64_t ), sizeof( uint64_t ) );
+    if ( iSize > static_cast<uint64_t>( pEnd - pChunkData[c] ) ) { return false; }
+    pChunkData[c + 1] = pChunkData[c] + iSize;
+  }
+  // The points are restored as they have been read: the flags of the attributes are not filtered by m_iAttributes.
+  release();
+  m_bAlpha             = eHeader.m_bAlpha != 0;
+  m_bNormal            = eHeader.m_bNormal != 0;
+  m_bType              = eHeader.m_bType != 0;
+  m_bMultiColor        = eHeader.m_bMultiColor != 0;
+  m_iSkippedAttributes = eHeader.m_iSkippedAttributes;
+  m_bMortonOrder       = eHeader.m_bMortonOrder != 0;
+  m_iPositionBits      = eHeader.m_iPositionBits;
+  m_iNumPoints         = static_cast<int>( iNumPoints );
+  m_iNumDuplicate      = static_cast<int>( eHeader.m_iNumDuplicate );
+  m_bSort              = false;
+  m_pPoints.resize( iNumPoints );
+  if ( m_bAlpha ) {
+    m_pColors4.resize( iNumPoints );
+  } else {
+    m_pColors3.resize( iNumPoints );
+  }
+  if ( m_bNormal ) { m_pNormals.resize( iNumPoints ); }
+  if ( m_bType ) { m_pTypes.resize( iNumPoints ); }
+  if ( m_bMultiColor ) { m_pMultiColors3.resize( iCount * iNumPoints ); }
+  uint8_t*             pColors = reinterpret_cast<uint8_t*>( getColors() );
+  std::vector<uint8_t> pValid( iNumChunks, 0 );
+  runTasks( static_cast<int>( iNumChunks ), [&]( int c ) {
+    const size_t         iBegin = c * g_iCompressedChunkSize;
+    const size_t         iSize  = ( std::min )( iNumPoints, iBegin + g_iCompressedChunkSize ) - iBegin;
+    const uint8_t*       pIn    = pChunkData[c];
+    const uint8_t*       pInEnd = pChunkData[c + 1];
+    std::vector<uint8_t> pRaw;
+#ifdef USE_ZSTD
+    uint64_t iRawSize = 0;
+    if ( pInEnd - pIn < static_cast<ptrdiff_t>( sizeof( uint64_t ) ) ) { return; }
+    memcpy( &iRawSize, pIn, sizeof( uint64_t ) );
+    pRaw.resize( iRawSize );
+    const size_t iResult = ZSTD_decompress( pRaw.data(), pRaw.size(), pIn + sizeof( uint64_t ),
+                                            pInEnd - pIn - sizeof( uint64_t ) );
+    if ( ZSTD_isError( iResult ) || iResult != iRawSize ) { return; }
+    pIn    = pRaw.data();
+    pInEnd = pRaw.data() + pRaw.size();
+#endif
+    if ( pIn >= pInEnd ) { return; }
+    const bool bInteger     = *pIn++ != 0;
+    int32_t    pPrevious[3] = {0, 0, 0};
+    for ( size_t i = iBegin; i < iBegin + iSize; i++ ) {
+      for ( int k = 0; k < 3; k++ ) {
+        uint32_t iCode = 0;
+        if ( !getVarint( pIn, pInEnd, iCode ) ) { return; }
+        pPrevious[k] = static_cast<int32_t>( static_cast<uint32_t>( pPrevious[k] ) +
+                                             static_cast<uint32_t>( unzigzag( iCode ) ) );
+        if ( bInteger ) {
+          m_pPoints[i][k] = static_cast<float>( pPrevious[k] );
+        } else {
+          memcpy( &m_pPoints[i][k], &pPrevious[k], sizeof( float ) );
+        }
+      }
+    }
+    if ( !decodePlanes( pIn, pInEnd, pColors + iBegin * iNumColors, iNumColors, iSize ) ) { return; }
+    if ( m_bType && !decodePlanes( pIn, pInEnd, m_pTypes.data() + iBegin, 1, iSize ) ) { return; }
+    if ( m_bNormal ) {
+      if ( static_cast<size_t>( pInEnd - pIn ) < iSize * sizeof( Normal ) ) { return; }
+      memcpy( m_pNormals.data() + iBegin, pIn, iSize * sizeof( Normal ) );
+      pIn += iSize * sizeof( Normal );
     }
-    outfile.write( reinterpret_cast<char*>( m_pMultiColors3.data() ),
-                   m_iNumPoints * iCountMultiColors * sizeof( float ) * 3 );
+    if ( iNumMulti > 0 && !decodePlanes( pIn, pInEnd, reinterpret_cast<uint8_t*>( m_pMultiColors3.data() ) +
+                                                          iBegin * iNumMulti, iNumMulti, iSize ) ) {
+      return;
+    }
+    pValid[c] = pIn == pInEnd;
+  } );
+  if ( std::find( pValid.begin(), pValid.end(), 0 ) != pValid.end() ) {
+    release();
+    return false;
   }
-  outfile.close();
+  m_iIndex = m_iNumPoints;
+  return true;
 }
 
-typedef float ( *CastFunction )( unsigned char* pPointer );
 inline float castUChar( unsigned char* pPointer ) { return (float)( *( (unsigned char*)pPointer ) ); }
 inline float castChar( unsigned char* pPointer ) { return (float)( *( (char*)pPointer ) ); }
 inline float castUShort( unsigned char* pPointer ) { return (float)( *( (uint16_t*)pPointer ) ); }
@@ -640,21 +1309,324 @@ void getSize( const std::string& pFormat, int& iSize, CastFunction& eCastFunctio
   // clang-format on
 }
 
+template <typename T>
+inline T loadUnaligned( const uint8_t* pPointer ) {
+  T value;
+  memcpy( &value, pPointer, sizeof( T ) );
+  return value;
+}
+
+/**
+ * \brief decode the vertices [iBegin;iEnd[ of a binary_little_endian PLY body with a layout known at compile time.
+ *
+ * The positions are stored as TPos (float or double), the colors and the types as uchar and the normals as float. The
+ * conversions are identical to the ones of ObjectPointcloud::add() and the bounding box is computed in the same pass.
+ */
+template <typename TPos, bool bAlpha, bool bNormal, bool bType>
+static void decodeBinaryVertices( const uint8_t*          pData,
+                                  size_t                  iBegin,
+                                  size_t                  iEnd,
+                                  size_t                  iStride,
+                                  const std::vector<int>& pIndex,
+                                  Point*                  pPoints,
+                                  Color3u8*               pColors3,
+                                  Color4u8*               pColors4,
+                                  Normal*                 pNormals,
+                                  uint8_t*                pTypes,
+                                  Box&                    eBox ) {
+  const size_t iX = pIndex[0], iY = pIndex[1], iZ = pIndex[2], iR = pIndex[3], iG = pIndex[4], iB = pIndex[5];
+  const size_t iA = pIndex[6], iNx = pIndex[7], iNy = pIndex[8], iNz = pIndex[9], iT = pIndex[10];
+  Vec3         eMin = eBox.min(), eMax = eBox.max();
+  for ( size_t i = iBegin; i < iEnd; i++ ) {
+    const uint8_t* pC = pData + i * iStride;
+    Point          ePoint( static_cast<float>( loadUnaligned<TPos>( pC + iX ) ),
+                           static_cast<float>( loadUnaligned<TPos>( pC + iY ) ),
+                           static_cast<float>( loadUnaligned<TPos>( pC + iZ ) ) );
+    pPoints[i] = ePoint;
+    if ( bAlpha ) {
+      pColors4[i] = Color4u8( pC[iR], pC[iG], pC[iB], pC[iA] );
+    } else {
+      pColors3[i] = Color3u8( pC[iR], pC[iG], pC[iB] );
+    }
+    if ( bNormal ) {
+      pNormals[i] = Normal( loadUnaligned<float>( pC + iNx ), loadUnaligned<float>( pC + iNy ),
+                            loadUnaligned<float>( pC + iNz ) );
+    }
+    if ( bType ) { pTypes[i] = pC[iT]; }
+    for ( int c = 0; c < 3; c++ ) {
+      eMin[c] = ePoint[c] < eMin[c] ? ePoint[c] : eMin[c];
+      eMax[c] = ePoint[c] > eMax[c] ? ePoint[c] : eMax[c];
+    }
+  }
+  eBox = Box( eMin, eMax );
+}
+
+template <typename TPos>
+static void decodeBinaryVertices( bool                    bAlpha,
+                                  bool                    bNormal,
+                                  bool                    bType,
+                                  const uint8_t*          pData,
+                                  size_t                  iBegin,
+                                  size_t                  iEnd,
+                                  size_t                  iStride,
+                                  const std::vector<int>& pIndex,
+                                  Point*                  pPoints,
+                                  Color3u8*               pColors3,
+                                  Color4u8*               pColors4,
+                                  Normal*                 pNormals,
+                                  uint8_t*                pTypes,
+                                  Box&                    eBox ) {
+  // clang-format off
+#define DECODE( A, N, T ) decodeBinaryVertices<TPos, A, N, T>( pData, iBegin, iEnd, iStride, pIndex, pPoints, pColors3, pColors4, pNormals, pTypes, eBox )
+  if      ( !bAlpha && !bNormal && !bType ) { DECODE( false, false, false ); }
+  else if ( !bAlpha && !bNormal &&  bType ) { DECODE( false, false, true  ); }
+  else if ( !bAlpha &&  bNormal && !bType ) { DECODE( false, true,  false ); }
+  else if ( !bAlpha &&  bNormal &&  bType ) { DECODE( false, true,  true  ); }
+  else if (  bAlpha && !bNormal && !bType ) { DECODE( true,  false, false ); }
+  else if (  bAlpha && !bNormal &&  bType ) { DECODE( true,  false, true  ); }
+  else if (  bAlpha &&  bNormal && !bType ) { DECODE( true,  true,  false ); }
+  else                                      { DECODE( true,  true,  true  ); }
+#undef DECODE
+  // clang-format on
+}
+
+inline bool isSpace( char c ) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+inline bool isDigit( char c ) { return c >= '0' && c <= '9'; }
+
+/**
+ * \brief parse a decimal floating point value without using the locale.
+ *
+ * Values with at most 7 significant digits and a small exponent are computed with one correctly rounded float
+ * operation, the other ones are converted by strtof(). The result is the one of "std::istream >> float".
+ * \return End of the token or nullptr if the token is not a plain decimal value.
+ */
+static const char* parseFloat( const char* pBegin, const char* pEnd, float& fValue ) {
+  static const float pPow10[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+  const char*        p          = pBegin;
+  bool               bNegative  = false;
+  uint64_t           iMantissa  = 0;
+  int                iExponent = 0, iNumDigits = 0;
+  if ( p < pEnd && ( *p == '-' || *p == '+' ) ) { bNegative = *p++ == '-'; }
+  for ( ; p < pEnd && isDigit( *p ); p++, iNumDigits++ ) { iMantissa = iMantissa * 10 + ( *p - '0' ); }
+  if ( p < pEnd && *p == '.' ) {
+    for ( p++; p < pEnd && isDigit( *p ); p++, iNumDigits++, iExponent-- ) {
+      iMantissa = iMantissa * 10 + ( *p - '0' );
+    }
+  }
+  if ( iNumDigits == 0 ) { return nullptr; }
+  if ( p < pEnd && ( *p == 'e' || *p == 'E' ) ) {
+    bool bNegativeExponent = false;
+    int  iValue = 0, iNumExponentDigits = 0;
+    p++;
+    if ( p < pEnd && ( *p == '-' || *p == '+' ) ) { bNegativeExponent = *p++ == '-'; }
+    for ( ; p < pEnd && isDigit( *p ); p++, iNumExponentDigits++ ) {
+      if ( iValue < 100000 ) { iValue = iValue * 10 + ( *p - '0' ); }
+    }
+    if ( iNumExponentDigits == 0 ) { return nullptr; }
+    iExponent += bNegativeExponent ? -iValue : iValue;
+  }
+  if ( p < pEnd && !isSpace( *p ) ) { return nullptr; }
+  if ( iNumDigits <= 19 && iMantissa <= ( 1 << 24 ) && iExponent >= -10 && iExponent <= 10 ) {
+    fValue = static_cast<float>( iMantissa );
+    fValue = iExponent < 0 ? fValue / pPow10[-iExponent] : fValue * pPow10[iExponent];
+    if ( bNegative ) { fValue = -fValue; }
+  } else {
+    std::string sToken( pBegin, p );
+    char*       pTokenEnd = nullptr;
+    errno                 = 0;
+    fValue                = strtof( sToken.c_str(), &pTokenEnd );
+    if ( errno == ERANGE || pTokenEnd != sToken.c_str() + sToken.size() ) { return nullptr; }
+  }
+  return p;
+}
+
+//! Count the non empty lines of a text buffer.
+static size_t countLines( const char* p, const char* pEnd ) {
+  size_t iCount   = 0;
+  bool   bContent = false;
+  for ( ; p < pEnd; p++ ) {
+    if ( *p == '\n' ) {
+      iCount += bContent ? 1 : 0;
+      bContent = false;
+    } else if ( !isSpace( *p ) ) {
+      bContent = true;
+    }
+  }
+  return iCount + ( bContent ? 1 : 0 );
+}
+
+bool ObjectPointcloud::readAscii( const char* pData, size_t iSize, int iOrder, const std::vector<int>& pOrder ) {
+  // The body is split in chunks aligned on line boundaries: the lines of each chunk are counted, then each chunk is
+  // parsed in parallel and writes its points at the index given by the prefix sum of the line counts.
+  const size_t         iChunkSize = 1 << 22;
+  const int            iNumChunks = static_cast<int>( ( std::min )( iSize / iChunkSize + 1, size_t( 256 ) ) );
+  const char*          pEnd       = pData + iSize;
+  std::vector<size_t>  pStart( iNumChunks + 1, iSize ), pFirstPoint( iNumChunks + 1, 0 );
+  std::vector<Box>     pBox( iNumChunks );
+  std::vector<uint8_t> pError( iNumChunks, 0 );
+  pStart[0] = 0;
+  for ( int c = 1; c < iNumChunks; c++ ) {
+    size_t      iFrom = ( std::max )( iSize / iNumChunks * c, pStart[c - 1] );
+    const char* p     = static_cast<const char*>( memchr( pData + iFrom, '\n', iSize - iFrom ) );
+    pStart[c]         = p != nullptr ? static_cast<size_t>( p + 1 - pData ) : iSize;
+  }
+  runTasks( iNumChunks, [&]( int c ) {
+    pFirstPoint[c + 1] = countLines( pData + pStart[c], pData + pStart[c + 1] );
+  } );
+  for ( int c = 0; c < iNumChunks; c++ ) { pFirstPoint[c + 1] += pFirstPoint[c]; }
+  if ( pFirstPoint[iNumChunks] < static_cast<size_t>( m_iNumPoints ) ) { return false; }
+
+  const size_t countMultiColors = getNumMultiColors();
+  runTasks( iNumChunks, [&]( int c ) {
+    std::vector<float> pF( iOrder + 1, 0.f );
+    float*             pS        = pF.data() + 1;
+    const char*        p         = pData + pStart[c];
+    const char*        pChunkEnd = pData + pStart[c + 1];
+    for ( size_t i = pFirstPoint[c]; i < static_cast<size_t>( m_iNumPoints ) && p < pChunkEnd; ) {
+      int iToken = 0;
+      while ( !pError[c] && p < pChunkEnd && *p != '\n' ) {
+        if ( isSpace( *p ) ) {
+          p++;
+        } else if ( iToken >= iOrder || ( p = parseFloat( p, pEnd, pS[iToken++] ) ) == nullptr ) {
+          pError[c] = 1;
+        }
+      }
+      if ( pError[c] || ( iToken != 0 && iToken != iOrder ) ) {
+        pError[c] = 1;
+        break;
+      }
+      p++;
+      if ( iToken == 0 ) { continue; }
+      const Point  ePoint( pS[pOrder[0]], pS[pOrder[1]], pS[pOrder[2]] );
+      const Color4 eColor( pS[pOrder[3]], pS[pOrder[4]], pS[pOrder[5]], pS[pOrder[6]] );
+      m_pPoints[i] = ePoint;
+      if ( m_bAlpha ) {
+        m_pColors4[i] = toColor8Bit( eColor );
+      } else {
+        m_pColors3[i] = toColor8Bit( Color3( eColor ) );
+      }
+      if ( m_bNormal ) { m_pNormals[i] = Normal( pS[pOrder[7]], pS[pOrder[8]], pS[pOrder[9]] ); }
+      if ( m_bType ) { m_pTypes[i] = static_cast<uint8_t>( pS[pOrder[10]] ); }
+      for ( size_t k = 0; k < countMultiColors; k++ ) {
+        setMultiColors3(
+            i, k, Color3( pS[pOrder[11 + k * 3 + 0]], pS[pOrder[11 + k * 3 + 1]], pS[pOrder[11 + k * 3 + 2]] ) );
+      }
+      pBox[c].update( ePoint );
+      i++;
+    }
+  } );
+  if ( std::find( pError.begin(), pError.end(), 1 ) != pError.end() ) { return false; }
+  for ( auto& eBox : pBox ) { m_eBox.update( eBox ); }
+  m_iIndex = m_iNumPoints;
+  return true;
+}
+
+bool ObjectPointcloud::readBinaryLittleEndian( const uint8_t*                   pData,
+                                               size_t                           iSize,
+                                               size_t                           iStride,
+                                               const std::vector<int>&          pIndex,
+                                               const std::vector<CastFunction>& pCast,
+                                               size_t                           iFirstPoint,
+                                               size_t                           iNumPoints ) {
+  if ( iFirstPoint + iNumPoints > static_cast<size_t>( m_iNumPoints ) || iNumPoints * iStride > iSize ) {
+    return false;
+  }
+  // The common layouts are decoded by specialized functions: float or double positions, uchar colors, float normals
+  // and uchar type. The other ones use the cast functions of each property.
+  const size_t countMultiColors = getNumMultiColors();
+  const bool   bDouble          = pCast[0] == castDouble && pCast[1] == castDouble && pCast[2] == castDouble;
+  const bool   bFloat           = pCast[0] == castFloat && pCast[1] == castFloat && pCast[2] == castFloat;
+  const bool   bSpecialized =
+      countMultiColors == 0 && ( bFloat || bDouble ) &&
+      ( pCast[3] == castUChar && pCast[4] == castUChar && pCast[5] == castUChar ) &&
+      ( !m_bAlpha || pCast[6] == castUChar ) &&
+      ( !m_bNormal || ( pCast[7] == castFloat && pCast[8] == castFloat && pCast[9] == castFloat ) ) &&
+      ( !m_bType || pCast[10] == castUChar );
+
+  // Each thread decodes a range of the vertex block and writes to the preallocated slots of these vertices: pData
+  // stores the vertices iFirstPoint to iFirstPoint + iNumPoints - 1.
+  Point*           pPoints    = m_pPoints.data() + iFirstPoint;
+  Color3u8*        pColors3   = m_bAlpha ? nullptr : m_pColors3.data() + iFirstPoint;
+  Color4u8*        pColors4   = m_bAlpha ? m_pColors4.data() + iFirstPoint : nullptr;
+  Normal*          pNormals   = m_bNormal ? m_pNormals.data() + iFirstPoint : nullptr;
+  uint8_t*         pTypes     = m_bType ? m_pTypes.data() + iFirstPoint : nullptr;
+  const size_t     iChunkSize = 1 << 16;
+  const int        iNumChunks = static_cast<int>( ( iNumPoints + iChunkSize - 1 ) / iChunkSize );
+  std::vector<Box> pBox( iNumChunks );
+  runTasks( iNumChunks, [&]( int c ) {
+    const size_t iBegin = c * iChunkSize;
+    const size_t iEnd   = ( std::min )( iBegin + iChunkSize, iNumPoints );
+    if ( bSpecialized && bFloat ) {
+      decodeBinaryVertices<float>( m_bAlpha, m_bNormal, m_bType, pData, iBegin, iEnd, iStride, pIndex, pPoints,
+                                   pColors3, pColors4, pNormals, pTypes, pBox[c] );
+    } else if ( bSpecialized ) {
+      decodeBinaryVertices<double>( m_bAlpha, m_bNormal, m_bType, pData, iBegin, iEnd, iStride, pIndex, pPoints,
+                                    pColors3, pColors4, pNormals, pTypes, pBox[c] );
+    } else {
+      for ( size_t i = iFirstPoint + iBegin; i < iFirstPoint + iEnd; i++ ) {
+        auto*       pC = const_cast<unsigned char*>( pData + ( i - iFirstPoint ) * iStride );
+        const Point ePoint( pCast[0]( pC + pIndex[0] ), pCast[1]( pC + pIndex[1] ), pCast[2]( pC + pIndex[2] ) );
+        const Color4 eColor( pCast[3]( pC + pIndex[3] ), pCast[4]( pC + pIndex[4] ), pCast[5]( pC + pIndex[5] ),
+                             pCast[6]( pC + pIndex[6] ) );
+        m_pPoints[i] = ePoint;
+        if ( m_bAlpha ) {
+          m_pColors4[i] = toColor8Bit( eColor );
+        } else {
+          m_pColors3[i] = toColor8Bit( Color3( eColor ) );
+        }
+        if ( m_bNormal ) {
+          m_pNormals[i] = Normal( pCast[7]( pC + pIndex[7] ), pCast[8]( pC + pIndex[8] ), pCast[9]( pC + pIndex[9] ) );
+        }
+        if ( m_bType ) { m_pTypes[i] = static_cast<uint8_t>( pCast[10]( pC + pIndex[10] ) ); }
+        for ( size_t k = 0; k < countMultiColors; k++ ) {
+          setMultiColors3( i, k,
+                           Color3( pCast[11 + k * 3 + 0]( pC + pIndex[11 + k * 3 + 0] ),
+                                   pCast[11 + k * 3 + 1]( pC + pIndex[11 + k * 3 + 1] ),
+                                   pCast[11 + k * 3 + 2]( pC + pIndex[11 + k * 3 + 2] ) ) );
+        }
+        pBox[c].update( ePoint );
+      }
+    }
+  } );
+  for ( auto& eBox : pBox ) { m_eBox.update( eBox ); }
+  m_iIndex = iFirstPoint + iNumPoints;
+  return true;
+}
+
 bool ObjectPointcloud::read( const std::string&        pFilename,
                              int                       iFrameIndex,
                              bool                      bBinary,
                              int                       iDropDups,
+                             bool                      bMortonOrder,
                              std::vector<std::string>& pTypeName ) {
-  m_eFilename = createFilename( pFilename, iFrameIndex );
+  m_eFilename    = createFilename( pFilename, iFrameIndex );
+  m_iDataOffset  = 0;
+  m_iFileFormat  = 0;
+  m_bMortonOrder = false;
   std::string strBinary;
   if ( bBinary ) {
-    strBinary = getBinaryName( m_eFilename, iDropDups );
-    if ( exist( strBinary ) && readBinary( strBinary, iFrameIndex ) ) { return true; }
+    strBinary = CacheDirectory::getInstance().getBinaryName( m_eFilename, iDropDups, bMortonOrder );
+    // The cache files written with another quantization are rewritten: a lossy cache is only used if requested.
+    if ( exist( strBinary ) && readBinary( strBinary, iFrameIndex, iDropDups ) && m_bMortonOrder == bMortonOrder &&
+         m_iPositionBits == m_iQuantization ) {
+      CacheDirectory::getInstance().touch( strBinary );
+      return true;
+    }
+    m_bMortonOrder = false;
+  }
+  // The gzip and zstd files are decompressed by a thread while the header and the vertices are parsed.
+  const bool         bCompressed = isCompressed( m_eFilename );
+  std::string        eLine, s1, s2;
+  std::ifstream      inputFile;
+  DecompressedStream inputCompressed;
+  std::istream&      inputPly = bCompressed ? static_cast<std::istream&>( inputCompressed ) : inputFile;
+  Prefetcher::getInstance().wait( m_eFilename );
+  if ( bCompressed ) {
+    inputCompressed.open( m_eFilename );
+  } else {
+    inputFile.open( m_eFilename.c_str(), std::ios::in | std::ios::binary );
   }
-  std::string   eLine, s1, s2;
-  std::ifstream inputPly;
-  inputPly.open( m_eFilename.c_str(), std::ios::in | std::ios::binary );
-  if ( !inputPly.is_open() ) {
+  if ( bCompressed ? !inputCompressed.is_open() : !inputFile.is_open() ) {
     printf( "\nPointcloudReader: Couldn't open %s \n", m_eFilename.c_str() );
     exit( 1 );
   }
@@ -845,10 +1817,53 @@ bool ObjectPointcloud::read( const std::string&        pFilename,
     reset();
     return false;
   }
+  // The binary files store all the attributes: the attributes that are not requested are dropped once written.
+  const uint8_t iAttributes = m_iAttributes;
+  if ( bBinary ) { m_iAttributes = ATTRIBUTE_ALL; }
   allocate( pSize[6] != 0, pSize[7] != 0 || pSize[8] != 0 || pSize[9] != 0, pSize[10] != 0, iNumPoints, iFrameIndex,
             0 );
-  const size_t countMultiColors = m_eRigParameters.getCount();
-  if ( bAscii ) {
+  m_iAttributes = iAttributes;
+  const size_t countMultiColors = getNumMultiColors();
+  bool         bMapped          = false;
+  m_iFileFormat                 = bAscii ? 1 : bLittleEndian ? 2 : 0;
+  m_iDataOffset                 = bCompressed ? 0 : static_cast<uint64_t>( inputPly.tellg() );
+  if ( bLittleEndian && !bCompressed ) { m_iDataOffset += static_cast<uint64_t>( iNumHeader ) * iSizeHeader; }
+  if ( bLittleEndian && bCompressed ) {
+    // The vertices are decoded by blocks, the decompression thread inflates the next block meanwhile. The ascii
+    // compressed files are parsed by the stream reader.
+    const size_t         iBlockPoints = size_t( 1 ) << 18;
+    std::vector<uint8_t> pBlock( iBlockPoints * iIndex );
+    if ( iNumHeader > 0 ) { inputPly.ignore( iNumHeader * iSizeHeader ); }
+    bMapped = true;
+    for ( size_t i = 0; bMapped && i < static_cast<size_t>( iNumPoints ); i += iBlockPoints ) {
+      const size_t iCount = ( std::min )( iBlockPoints, static_cast<size_t>( iNumPoints ) - i );
+      inputPly.read( reinterpret_cast<char*>( pBlock.data() ), iCount * iIndex );
+      bMapped = inputPly && readBinaryLittleEndian( pBlock.data(), iCount * iIndex, iIndex, pIndex, pCast, i, iCount );
+    }
+    if ( !bMapped ) {
+      printf( "PointcloudReader: %s is truncated \n", m_eFilename.c_str() );
+      reset();
+      return false;
+    }
+  } else if ( bAscii && !bCompressed ) {
+    // Parallel path: the body is mapped and parsed by chunks, the stream reader is used if the lines do not match the
+    // vertex element.
+    size_t    iOffset = static_cast<size_t>( m_iDataOffset );
+    MemoryMap eMemoryMap;
+    bMapped = eMemoryMap.open( m_eFilename ) && iOffset <= eMemoryMap.size() &&
+              readAscii( reinterpret_cast<const char*>( eMemoryMap.data() ) + iOffset, eMemoryMap.size() - iOffset,
+                         iOrder, pOrder );
+    eMemoryMap.close();
+  } else if ( bLittleEndian && !bCompressed ) {
+    // Zero-copy path: the vertex data are decoded directly from the mapped file.
+    size_t    iOffset = static_cast<size_t>( m_iDataOffset );
+    MemoryMap eMemoryMap;
+    bMapped = eMemoryMap.open( m_eFilename ) && iOffset <= eMemoryMap.size() &&
+              readBinaryLittleEndian( eMemoryMap.data() + iOffset, eMemoryMap.size() - iOffset, iIndex, pIndex, pCast,
+                                      0, static_cast<size_t>( m_iNumPoints ) );
+    eMemoryMap.close();
+  }
+  if ( bAscii && !bMapped ) {
     std::vector<float> pF;
     pF.resize( iOrder + 1 );
     float* pS = nullptr;
@@ -867,7 +1882,8 @@ bool ObjectPointcloud::read( const std::string&        pFilename,
       }
     }
     pF.clear();
-  } else if ( bLittleEndian ) {
+  }
+  if ( bLittleEndian && !bMapped ) {
     std::vector<unsigned char> pC;
     pC.resize( iIndex );
     if ( iNumHeader > 0 ) { inputPly.ignore( iNumHeader * iSizeHeader ); }
@@ -898,9 +1914,23 @@ bool ObjectPointcloud::read( const std::string&        pFilename,
     }
     pC.clear();
   }
-  inputPly.close();
+  // The frames read from a truncated or corrupted stream are not kept nor written in the binary cache.
+  if ( ( !bMapped && !inputPly ) || ( bCompressed && inputCompressed.getError() ) ) {
+    printf( "PointcloudReader: %s is truncated or corrupted \n", m_eFilename.c_str() );
+    reset();
+    return false;
+  }
+  if ( bCompressed ) {
+    inputCompressed.close();
+  } else {
+    inputFile.close();
+  }
   if ( iDropDups > 0 ) { removeDuplicatePoints( iDropDups ); }
-  if ( bBinary ) { writeBinary( strBinary ); }
+  if ( bMortonOrder ) { sortMortonOrder(); }
+  if ( bBinary ) {
+    writeBinary( strBinary, iDropDups );
+    dropAttributes();
+  }
   if ( m_eRigParameters.exist() ) { m_eRigParameters.trace(); }
   return true;
 }
@@ -991,6 +2021,13 @@ void ObjectPointcloud::computeDistance( std::vector<Color3>& eColors ) {
   }
 }
 
+//! Squared radius of the unit neighbourhood of the normalized sequence in the space of the object: the model matrix
+//! is a uniform positive scale and a translation.
+float ObjectPointcloud::getSearchRadius() {
+  const float fScale = m_eModel[0][0] > 0.f ? m_eModel[0][0] : 1.f;
+  return 1.f / ( fScale * fScale );
+}
+
 void ObjectPointcloud::computeDuplicate( std::vector<Color3>& eColors ) {
   std::vector<float> eDistance;
   eColors.resize( m_iNumPoints );
@@ -998,7 +2035,7 @@ void ObjectPointcloud::computeDuplicate( std::vector<Color3>& eColors ) {
   typedef KDTreeSingleIndexAdaptor<L2_Simple_Adaptor<float, ObjectPointcloud>, ObjectPointcloud, 3> KdTree;
   KdTree eKdTree( 3, *this, KDTreeSingleIndexAdaptorParams( 10 ) );
   eKdTree.buildIndex();
-  const auto radius = static_cast<uint8_t>( 1.f );
+  const float radius = getSearchRadius();
   for ( size_t i = 0; i < static_cast<size_t>( m_iNumPoints ); i++ ) {
     nanoflann::SearchParams               params;
     std::vector<std::pair<size_t, float>> values;
@@ -1018,7 +2055,7 @@ void ObjectPointcloud::colorBasedType( std::vector<Color3>& eColors ) {
   typedef KDTreeSingleIndexAdaptor<L2_Simple_Adaptor<float, ObjectPointcloud>, ObjectPointcloud, 3> KdTree;
   KdTree eKdTree( 3, *this, KDTreeSingleIndexAdaptorParams( 10 ) );
   eKdTree.buildIndex();
-  const auto radius = static_cast<uint8_t>( 1.f );
+  const float radius = getSearchRadius();
   for ( size_t i = 0; i < static_cast<size_t>( m_iNumPoints ); i++ ) {
     nanoflann::SearchParams               params;
     std::vector<std::pair<size_t, float>> values;
@@ -1028,7 +2065,7 @@ void ObjectPointcloud::colorBasedType( std::vector<Color3>& eColors ) {
       if ( getTypes()[values[j].first] == m_iTypeColor - 1 ) { match = true; }
     }
     if ( match ) { count++; }
-    eColors[i] = match ? g_pColorPalette[m_iTypeColor - 1] : getColors3()[i];
+    eColors[i] = match ? g_pColorPalette[m_iTypeColor - 1] : getColors3( i );
   }
   printf( " %9d / %9d points of type %d  \n", static_cast<int>( count ), m_iNumPoints, m_iTypeColor - 1 );
 }
@@ -1047,7 +2084,7 @@ void ObjectPointcloud::load() {
     glGenVertexArrays( 1, &m_uiVAO );
     glGenBuffers( 1, &m_uiVBO );
     glGenBuffers( 1, &m_uiCBO );
-    if ( m_eRigParameters.exist() ) { glGenBuffers( 1, &m_uiMCBO ); }
+    if ( getNumMultiColors() > 0 ) { glGenBuffers( 1, &m_uiMCBO ); }
     glGenBuffers(1, &m_uiIBO);
     glBindVertexArray( m_uiVAO );
     glBindBuffer( GL_ARRAY_BUFFER, m_uiVBO );
@@ -1058,8 +2095,8 @@ void ObjectPointcloud::load() {
 
     glBindBuffer( GL_ARRAY_BUFFER, m_uiCBO );
     if ( !( ( m_iDisplayMetric > 0 ) || m_bDisplayDuplicate || m_iTypeColor > 0 ) ) {
-      glBufferData( GL_ARRAY_BUFFER, ( 3 + getAlpha() ) * m_iNumPoints * sizeof( float ), getColors(), GL_STATIC_DRAW );
-      glVertexAttribPointer( program.attrib( "color" ), 3 + getAlpha(), GL_FLOAT, GL_FALSE, 0, nullptr );
+      glBufferData( GL_ARRAY_BUFFER, ( 3 + getAlpha() ) * m_iNumPoints * sizeof( uint8_t ), getColors(), GL_STATIC_DRAW );
+      glVertexAttribPointer( program.attrib( "color" ), 3 + getAlpha(), GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr );
     } else {
       std::vector<Color3> eColors;
       if ( ( m_iDisplayMetric > 0 ) ) {
@@ -1075,16 +2112,16 @@ void ObjectPointcloud::load() {
     glEnableVertexAttribArray( program.attrib( "color" ) );
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
 
-    if ( m_eRigParameters.exist() ) {
+    if ( getNumMultiColors() > 0 ) {
       size_t count = m_eRigParameters.getCount();
       glBindBuffer( GL_ARRAY_BUFFER, m_uiMCBO );
-      glBufferData( GL_ARRAY_BUFFER, 3 * sizeof( float ) * count * m_iNumPoints, getMultiColors3().data(),
+      glBufferData( GL_ARRAY_BUFFER, 3 * sizeof( uint8_t ) * count * m_iNumPoints, getMultiColors3().data(),
                     GL_STATIC_DRAW );
       for ( size_t i = 0; i < count; i++ ) {
         glEnableVertexAttribArray( static_cast<GLuint>( i ) );
-        glVertexAttribPointer( static_cast<GLuint>( i ), 3, GL_FLOAT, GL_FALSE,
-                               static_cast<GLsizei>( 3 * count * sizeof( float ) ),
-                               (void*)( i * 3 * sizeof( float ) ) );
+        glVertexAttribPointer( static_cast<GLuint>( i ), 3, GL_UNSIGNED_BYTE, GL_TRUE,
+                               static_cast<GLsizei>( 3 * count * sizeof( uint8_t ) ),
+                               (void*)( i * 3 * sizeof( uint8_t ) ) );
       }
       glEnableVertexAttribArray( program.attrib( "colorM" ) );
       glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -1105,7 +2142,7 @@ void ObjectPointcloud::unload() {
 }
 
 void ObjectPointcloud::draw( bool ) {
-  if ( !m_eRigParameters.exist() || m_iMultiColorIndex >= static_cast<int>( m_eRigParameters.getCount() ) ) {
+  if ( getNumMultiColors() == 0 || m_iMultiColorIndex >= static_cast<int>( m_eRigParameters.getCount() ) ) {
     m_iMultiColorIndex = -3;
   }
   size_t iMode = m_iMultiColorIndex;
@@ -65,6 +65,8 @@ bool RendererParameters::parseCfg( int argc, char* argv[] ) {
     ( "SrcFile",         m_pFileSrc,           std::string(""), "Source Ply filename (used for comparison)."             )
     ( "SrcDir",          m_pDirSrc,            std::string(""), "Source Ply directory (used for comparison)."            )
     ( "b,binary",        m_bCreateBinaryFiles, false,           "Create temp binary files."                              )
+    ( "createContainer", m_pContainerFile,     std::string(""), "Write the point cloud sequence in a single file\n"
+      "  container (.pcs) that can be used as Ply input filename."                                                       )
     ( "o,RgbFile",       m_pRgbFile,           std::string(""), "Output RGB 8bits filename (specify prefix file name)."  )
     ( "x,camera",        m_pCameraPathFile,    std::string(""), "Camera path filename."                                  )
     ( "y,viewpoint",     m_pViewpointFile,     std::string(""), "Viewpoint filename."                                    )
@@ -124,6 +126,20 @@ bool RendererParameters::parseCfg( int argc, char* argv[] ) {
     ( "synchronize",     m_bSynchronize,       false,           "Synchronize multi-windows."                             )
     ( "box",             m_iBoxSize,           -1,              "Bounding box size."                                     )
     ( "dropdups",        m_iDropDups,          2,               "Drop same coordinate points (0:No, 1:drop, 2:average)." )
+    ( "mortonOrder",     m_bMortonOrder,       false,           "Reorder the points of the point clouds in Morton order\n"
+      "  on load (stored in the binary files)."                                                                         )
+    ( "quantization",    m_iQuantization,      0,               "Bits per coordinate of the positions of the non voxelized\n"
+      "  contents (0: lossless, max 16), the binary files quantized with other bits are rewritten."                     )
+    ( "memoryBudget",    m_iMemoryBudget,      0,               "Memory budget of the decoded frames in MB (0: load all the frames).\n"
+      "  If the sequence is larger, the frames are loaded and evicted by a background thread following the playback.")
+    ( "ioPrefetch",      m_iIoPrefetch,        4,               "Number of frames read ahead asynchronously in streaming mode\n"
+      "  (0: disable)."                                                                                                 )
+    ( "compressedBudget", m_iCompressedBudget, 0,               "Memory budget of the frames kept compressed in memory in\n"
+      "  streaming mode in MB (0: disable), they are decompressed instead of being read again."                         )
+    ( "cacheDir",        m_pCacheDir,          std::string(""), "Directory of the binary files (local SSD), shared by the\n"
+      "  sequences and the processes (empty: .binary next to the sources)."                                             )
+    ( "cacheSize",       m_iCacheSize,         10240,           "Size of the cache directory in MB above which the least\n"
+      "  recently used files are removed (0: no limit)."                                                                )
     ( "c,center",        m_bCenter,            false,           "Center the object in the bounding box."                 )
     ( "s,scale",         m_iScaleMode,         0,               
         "Scale mode:    0: disable, \n"
@@ -136,7 +152,11 @@ bool RendererParameters::parseCfg( int argc, char* argv[] ) {
     ( "visible",         m_bVisible,          true,            "Open user interface."                                    )
     ( "lighting",        m_bLighting,         false,           "Enable lighting (only for mesh objects)."                )
     ( "softwareRenderer",m_bSoftwareRenderer, false,           "Pure software rendererer without OpenGL/GLFW. "
-    "  Note: this mode disables GUI and screen renderering and only allows to create offscreen RGB videos."              );
+    "  Note: this mode disables GUI and screen renderering and only allows to create offscreen RGB videos."              )
+    ( "reorderDepth",    m_iReorderDepth,     0,               "Number of images of the software renderer kept in memory\n"
+      "  until they are written in order (0: twice the number of threads)."                                             )
+    ( "deferredShading", m_bDeferredShading,  false,           "Software renderer: rasterize the meshes in a visibility\n"
+      "  buffer, then shade each visible pixel once."                                                                   );
 
   // clang-format on  
 
@@ -190,6 +210,30 @@ bool RendererParameters::check( bool verbose ) {
       if (verbose) { printf("Error: Blend mode value not supported, %d not in[0;1].\n", m_iBlendMode); }
       return false;
   }
+  if ( m_iMemoryBudget < 0 ) {
+    if( verbose ) { printf( "Error: Memory budget value not supported, %d must be >= 0.\n", m_iMemoryBudget ); }
+    return false;
+  }
+  if ( m_iIoPrefetch < 0 ) {
+    if( verbose ) { printf( "Error: I/O prefetch value not supported, %d must be >= 0.\n", m_iIoPrefetch ); }
+    return false;
+  }
+  if ( m_iCompressedBudget < 0 ) {
+    if( verbose ) { printf( "Error: Compressed budget value not supported, %d must be >= 0.\n", m_iCompressedBudget ); }
+    return false;
+  }
+  if ( m_iCacheSize < 0 ) {
+    if( verbose ) { printf( "Error: Cache size value not supported, %d must be >= 0.\n", m_iCacheSize ); }
+    return false;
+  }
+  if ( m_iQuantization < 0 || m_iQuantization > 16 ) {
+    if( verbose ) { printf( "Error: Quantization value not supported, %d not in[0;16].\n", m_iQuantization ); }
+    return false;
+  }
+  if ( m_iReorderDepth < 0 ) {
+    if( verbose ) { printf( "Error: Reorder depth value not supported, %d must be >= 0.\n", m_iReorderDepth ); }
+    return false;
+  }
   if( m_bSoftwareRenderer ) {
     if( m_pRgbFile.empty() ){
       if( verbose ) { printf( "Error: SW rendereing need to define the RgbFile input parameter. \n" ); }
@@ -243,6 +287,14 @@ void RendererParameters::print() {
   }
   printf( " Camera path     = %s \n", m_pCameraPathFile.c_str() );
   printf( " Camera path Idx = %d \n", m_iCameraPathIndex );
+  printf( " Memory budget   = %d MB \n", m_iMemoryBudget );
+  printf( " I/O prefetch    = %d \n", m_iIoPrefetch );
+  printf( " Compressed bud. = %d MB \n", m_iCompressedBudget );
+  printf( " Cache directory = %s \n", m_pCacheDir.c_str() );
+  printf( " Cache size      = %d MB \n", m_iCacheSize );
+  printf( " Morton order    = %d \n", m_bMortonOrder );
+  printf( " Quantization    = %d \n", m_iQuantization );
+  printf( " Container       = %s \n", m_pContainerFile.c_str() );
   printf( " Spline          = %d \n", m_bSpline );
   printf( " Viewpoint       = %s \n", m_pViewpointFile.c_str() );
   printf( " Overlay         = %d \n", m_bOverlay );
@@ -257,4 +309,6 @@ void RendererParameters::print() {
   printf( " Visible         = %d \n",  m_bVisible );
   printf( " Lighting        = %d \n",  m_bLighting );
   printf( " SoftwareRenderer= %d \n",  m_bSoftwareRenderer );
+  printf( " Reorder depth   = %d \n",  m_iReorderDepth );
+  printf( " Deferred shad.  = %d \n",  m_bDeferredShading );
 }
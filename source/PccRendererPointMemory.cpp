@@ -0,0 +1,165 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererPointMemory.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+static const size_t g_iHugePageSize = size_t( 1 ) << 21;
+static const int    g_iNumSamples   = 8;  // pages sampled by recordAccess()
+#ifdef __linux__
+static const int g_iMpolPreferred = 1;  // MPOL_PREFERRED of <numaif.h>, libnuma is not required
+#endif
+
+static thread_local int g_iPreferredNode = -1;
+
+//! Parse a cpu or node list of the sysfs as "0-15,32-47".
+static std::vector<int> parseList( const std::string& sList ) {
+  std::vector<int>  pCpus;
+  std::stringstream eStream( sList );
+  std::string       sRange;
+  while ( std::getline( eStream, sRange, ',' ) ) {
+    int iFirst = 0, iLast = 0;
+    int iCount = sscanf( sRange.c_str(), "%d-%d", &iFirst, &iLast );
+    if ( iCount < 1 ) { continue; }
+    if ( iCount == 1 ) { iLast = iFirst; }
+    for ( int i = iFirst; i <= iLast; i++ ) { pCpus.push_back( i ); }
+  }
+  return pCpus;
+}
+
+PointMemory& PointMemory::getInstance() {
+  static PointMemory eInstance;
+  return eInstance;
+}
+
+PointMemory::PointMemory() : m_iAllocatedSize( 0 ), m_iHugePageSize( 0 ), m_iLocalPages( 0 ), m_iRemotePages( 0 ) {
+#ifdef __linux__
+  // The ids of the online nodes can be sparse (e.g. "0,2-3"), the nodes without cpus only hold memory and are not used.
+  std::ifstream eOnline( "/sys/devices/system/node/online" );
+  std::string   sOnline;
+  if ( !eOnline.is_open() || !std::getline( eOnline, sOnline ) ) { return; }
+  for ( int iNode : parseList( sOnline ) ) {
+    std::ifstream    eFile( stringFormat( "/sys/devices/system/node/node%d/cpulist", iNode ) );
+    std::string      sList;
+    std::vector<int> pCpus;
+    if ( eFile.is_open() && std::getline( eFile, sList ) ) { pCpus = parseList( sList ); }
+    if ( pCpus.empty() ) { continue; }
+    for ( int iCpu : pCpus ) {
+      if ( iCpu >= static_cast<int>( m_pCpuNode.size() ) ) { m_pCpuNode.resize( iCpu + 1, 0 ); }
+      m_pCpuNode[iCpu] = iNode;
+    }
+    m_pNodes.push_back( iNode );
+    m_iMaxNode = ( std::max )( m_iMaxNode, iNode );
+  }
+  m_iNumNodes = ( std::max )( static_cast<int>( m_pNodes.size() ), 1 );
+#endif
+}
+
+PointMemory::~PointMemory() {}
+
+int PointMemory::getPreferredNode() { return g_iPreferredNode; }
+
+void PointMemory::setPreferredNode( int iNode ) { g_iPreferredNode = iNode; }
+
+int PointMemory::getCurrentNode() const {
+#ifdef __linux__
+  int iCpu = sched_getcpu();
+  if ( iCpu >= 0 && iCpu < static_cast<int>( m_pCpuNode.size() ) ) { return m_pCpuNode[iCpu]; }
+#endif
+  return 0;
+}
+
+void* PointMemory::allocate( size_t iSize ) {
+  m_iAllocatedSize += iSize;
+#ifdef __linux__
+  if ( iSize >= g_iHugePageSize ) {
+    // The mapping is extended to cut a region aligned on a huge page, the kernel only backs the aligned 2 MB ranges.
+    const size_t iMapSize = ( iSize + g_iHugePageSize - 1 ) / g_iHugePageSize * g_iHugePageSize;
+    uint8_t*     pMap     = static_cast<uint8_t*>(
+        mmap( nullptr, iMapSize + g_iHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+    if ( pMap == MAP_FAILED ) { throw std::bad_alloc(); }
+    uint8_t* pData = reinterpret_cast<uint8_t*>( ( reinterpret_cast<uintptr_t>( pMap ) + g_iHugePageSize - 1 ) /
+                                                 g_iHugePageSize * g_iHugePageSize );
+    if ( pData > pMap ) { munmap( pMap, pData - pMap ); }
+    if ( pMap + g_iHugePageSize > pData ) { munmap( pData + iMapSize, pMap + g_iHugePageSize - pData ); }
+#ifdef MADV_HUGEPAGE
+    madvise( pData, iMapSize, MADV_HUGEPAGE );
+#endif
+    // The pages are placed on the preferred node when they are written first, whatever the thread that writes them.
+    // The node mask holds the ids up to the largest node id, the kernel reads maxnode - 1 bits.
+    if ( m_iNumNodes > 1 && g_iPreferredNode >= 0 && g_iPreferredNode <= m_iMaxNode ) {
+      const size_t               iBits = 8 * sizeof( unsigned long );
+      std::vector<unsigned long> pMask( m_iMaxNode / iBits + 1, 0 );
+      pMask[g_iPreferredNode / iBits] = 1UL << ( g_iPreferredNode % iBits );
+      syscall( SYS_mbind, pData, iMapSize, g_iMpolPreferred, pMask.data(), pMask.size() * iBits + 1, 0 );
+    }
+    m_iHugePageSize += iSize;
+    return pData;
+  }
+#endif
+  return ::operator new( iSize );
+}
+
+void PointMemory::deallocate( void* pData, size_t iSize ) {
+  m_iAllocatedSize -= iSize;
+#ifdef __linux__
+  if ( iSize >= g_iHugePageSize ) {
+    const size_t iMapSize = ( iSize + g_iHugePageSize - 1 ) / g_iHugePageSize * g_iHugePageSize;
+    munmap( pData, iMapSize );
+    m_iHugePageSize -= iSize;
+    return;
+  }
+#endif
+  ::operator delete( pData );
+}
+
+void PointMemory::recordAccess( const void* pData, size_t iSize ) {
+#ifdef __linux__
+  if ( m_iNumNodes <= 1 || pData == nullptr || iSize == 0 ) { return; }
+  const uintptr_t iPageSize = static_cast<uintptr_t>( sysconf( _SC_PAGESIZE ) );
+  void*           pPages[g_iNumSamples];
+  int             pStatus[g_iNumSamples];
+  for ( int i = 0; i < g_iNumSamples; i++ ) {
+    uintptr_t iAddress = reinterpret_cast<uintptr_t>( pData ) + iSize / g_iNumSamples * i;
+    pPages[i]          = reinterpret_cast<void*>( iAddress / iPageSize * iPageSize );
+  }
+  // move_pages() without target nodes returns the nodes of the pages.
+  if ( syscall( SYS_move_pages, 0, g_iNumSamples, pPages, nullptr, pStatus, 0 ) != 0 ) { return; }
+  const int iNode = getCurrentNode();
+  for ( int i = 0; i < g_iNumSamples; i++ ) {
+    if ( pStatus[i] < 0 ) { continue; }
+    ( pStatus[i] == iNode ? m_iLocalPages : m_iRemotePages )++;
+  }
+#endif
+}
+
+void PointMemory::printStats() {
+  // The hardware TLB misses are not counted: the ratio of the points mapped by huge pages is their proxy, each 2 MB
+  // page replacing 512 TLB entries. AnonHugePages is the memory of the process actually backed by huge pages.
+  uint64_t iAnonHugePages = 0;
+#ifdef __linux__
+  std::ifstream eFile( "/proc/self/smaps_rollup" );
+  std::string   sLine;
+  while ( std::getline( eFile, sLine ) ) {
+    if ( sLine.compare( 0, 14, "AnonHugePages:" ) == 0 ) {
+      iAnonHugePages = static_cast<uint64_t>( std::stoull( sLine.substr( 14 ) ) ) << 10;
+    }
+  }
+#endif
+  const uint64_t iAllocatedSize = m_iAllocatedSize;
+  printf( "PointMemory: %.1f MB of points, %.1f%% in huge page mappings, %.1f MB backed by huge pages \n",
+          iAllocatedSize / 1048576., iAllocatedSize > 0 ? 100. * m_iHugePageSize / iAllocatedSize : 0.,
+          iAnonHugePages / 1048576. );
+  const uint64_t iNumPages = m_iLocalPages + m_iRemotePages;
+  if ( m_iNumNodes > 1 ) {
+    printf( "PointMemory: %d NUMA nodes, %.1f%% of the %llu pages sampled by the renderers are local \n", m_iNumNodes,
+            iNumPages > 0 ? 100. * m_iLocalPages / iNumPages : 0., static_cast<unsigned long long>( iNumPages ) );
+  }
+}
@@ -0,0 +1,183 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererPrefetcher.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// The files are read by blocks, at most g_iQueueDepth blocks are submitted at the same time to io_uring. The data are
+// only loaded in the page cache: the blocks of the buffer are overwritten.
+static const uint64_t g_iBlockSize  = uint64_t( 1 ) << 20;
+static const int      g_iQueueDepth = 16;
+
+Prefetcher& Prefetcher::getInstance() {
+  static Prefetcher eInstance;
+  return eInstance;
+}
+
+Prefetcher::Prefetcher() {}
+
+Prefetcher::~Prefetcher() {
+  {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    m_bStop = true;
+    m_eQueue.clear();
+  }
+  m_eCondition.notify_all();
+  if ( m_eThread.joinable() ) { m_eThread.join(); }
+#ifdef USE_IO_URING
+  if ( m_bRing ) { io_uring_queue_exit( &m_eRing ); }
+#endif
+}
+
+void Prefetcher::prefetch( const std::vector<Request>& pRequests ) {
+  std::lock_guard<std::mutex> eLock( m_eMutex );
+  if ( !m_eThread.joinable() ) {
+    m_pBuffer.resize( g_iBlockSize * g_iQueueDepth );
+#ifdef USE_IO_URING
+    m_bRing = io_uring_queue_init( g_iQueueDepth, &m_eRing, 0 ) == 0;
+    if ( !m_bRing ) { printf( "Prefetcher: io_uring is not available, the blocks are read by a thread \n" ); }
+#endif
+    m_eThread = std::thread( &Prefetcher::process, this );
+  }
+  m_eQueue.clear();
+  for ( auto& eRequest : pRequests ) {
+    if ( !m_bReading || eRequest.m_sFilename != m_eCurrent.m_sFilename || eRequest.m_iOffset != m_eCurrent.m_iOffset ) {
+      m_eQueue.push_back( eRequest );
+    }
+  }
+  m_eCondition.notify_all();
+}
+
+void Prefetcher::wait( const std::string& sFilename, uint64_t iOffset ) {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  auto isRequest = [&]( const Request& eRequest ) {
+    return eRequest.m_sFilename == sFilename && eRequest.m_iOffset == iOffset;
+  };
+  m_eQueue.erase( std::remove_if( m_eQueue.begin(), m_eQueue.end(), isRequest ), m_eQueue.end() );
+  if ( m_bReading && isRequest( m_eCurrent ) ) {
+    auto eStart = std::chrono::steady_clock::now();
+    m_eCondition.wait( eLock, [&] { return !m_bReading || !isRequest( m_eCurrent ); } );
+    m_fStallTime = m_fStallTime + std::chrono::duration<double>( std::chrono::steady_clock::now() - eStart ).count();
+  }
+}
+
+void Prefetcher::printStats() {
+  printf( "Prefetcher: %.1f MB read, peak in flight = %.1f MB, stall time = %.3f s \n", m_iBytesRead / 1048576.,
+          m_iPeakBytesInFlight / 1048576., m_fStallTime.load() );
+}
+
+// The bytes in flight are only updated by the thread of the prefetcher, their peak is read by printStats().
+void Prefetcher::addBytesInFlight( uint64_t iSize ) {
+  m_iBytesInFlight += iSize;
+  if ( m_iBytesInFlight > m_iPeakBytesInFlight ) { m_iPeakBytesInFlight = m_iBytesInFlight; }
+}
+
+void Prefetcher::process() {
+  std::unique_lock<std::mutex> eLock( m_eMutex );
+  while ( true ) {
+    m_eCondition.wait( eLock, [&] { return m_bStop || !m_eQueue.empty(); } );
+    if ( m_bStop ) { break; }
+    m_eCurrent = m_eQueue.front();
+    m_eQueue.pop_front();
+    m_bReading = true;
+    eLock.unlock();
+    read( m_eCurrent );
+    eLock.lock();
+    m_bReading = false;
+    m_eCondition.notify_all();
+  }
+}
+
+void Prefetcher::read( const Request& eRequest ) {
+  uint64_t iFileSize = 0;
+  int64_t  iFileTime = 0;
+  if ( !getFileStatus( eRequest.m_sFilename, iFileSize, iFileTime ) || eRequest.m_iOffset >= iFileSize ) { return; }
+  const uint64_t iBegin = eRequest.m_iOffset;
+  const uint64_t iEnd =
+      eRequest.m_iSize > 0 ? ( std::min )( iFileSize, eRequest.m_iOffset + eRequest.m_iSize ) : iFileSize;
+#ifdef WIN32
+  std::ifstream eFile( eRequest.m_sFilename.c_str(), std::ios::binary | std::ios::in );
+  eFile.seekg( iBegin );
+  for ( uint64_t iPosition = iBegin; eFile && iPosition < iEnd; iPosition += g_iBlockSize ) {
+    uint64_t iLength = ( std::min )( g_iBlockSize, iEnd - iPosition );
+    addBytesInFlight( iLength );
+    eFile.read( reinterpret_cast<char*>( m_pBuffer.data() ), iLength );
+    m_iBytesInFlight -= iLength;
+    m_iBytesRead += static_cast<uint64_t>( eFile.gcount() );
+  }
+#else
+  int iFile = ::open( eRequest.m_sFilename.c_str(), O_RDONLY );
+  if ( iFile >= 0 ) {
+    // The readahead of the whole range is started by the kernel, the blocks are read to wait for its completion.
+    posix_fadvise( iFile, static_cast<off_t>( iBegin ), static_cast<off_t>( iEnd - iBegin ), POSIX_FADV_WILLNEED );
+    readBlocks( iFile, iBegin, iEnd );
+    ::close( iFile );
+  }
+#endif
+}
+
+#ifndef WIN32
+void Prefetcher::readBlocks( int iFile, uint64_t iBegin, uint64_t iEnd ) {
+#ifdef USE_IO_URING
+  if ( m_bRing ) {
+    // iNumPending blocks are queued in the ring and not completed, iNumSubmitted of them are submitted to the kernel.
+    uint64_t iSubmit = iBegin;
+    int      iBlock = 0, iNumPending = 0, iNumSubmitted = 0;
+    bool     bError   = false;
+    auto     complete = [&]( io_uring_cqe* pCompletion ) {
+      // The bytes actually read are counted: res is the length of a short read at the end of a file or an error.
+      if ( pCompletion->res > 0 ) { m_iBytesRead += static_cast<uint64_t>( pCompletion->res ); }
+      bError = bError || pCompletion->res < 0;
+      m_iBytesInFlight -= pCompletion->user_data;
+      io_uring_cqe_seen( &m_eRing, pCompletion );
+      iNumPending--;
+      iNumSubmitted--;
+    };
+    while ( iNumPending > 0 || ( iSubmit < iEnd && !bError ) ) {
+      while ( !bError && iSubmit < iEnd && iNumPending < g_iQueueDepth ) {
+        io_uring_sqe* pEntry = io_uring_get_sqe( &m_eRing );
+        if ( pEntry == nullptr ) { break; }
+        const unsigned iLength = static_cast<unsigned>( ( std::min )( g_iBlockSize, iEnd - iSubmit ) );
+        io_uring_prep_read( pEntry, iFile, m_pBuffer.data() + ( iBlock++ % g_iQueueDepth ) * g_iBlockSize, iLength,
+                            iSubmit );
+        pEntry->user_data = iLength;
+        addBytesInFlight( iLength );
+        iSubmit += iLength;
+        iNumPending++;
+      }
+      io_uring_cqe* pCompletion = nullptr;
+      const int     iSubmitted  = io_uring_submit( &m_eRing );
+      if ( iSubmitted > 0 ) { iNumSubmitted += iSubmitted; }
+      if ( iSubmitted < 0 || io_uring_wait_cqe( &m_eRing, &pCompletion ) < 0 ) {
+        // The ring can't be used anymore: the submitted reads are completed before the ring is released, the kernel
+        // must not write in m_pBuffer after its teardown. The remaining blocks are read by the thread.
+        while ( iNumSubmitted > 0 ) {
+          const int iResult = io_uring_wait_cqe( &m_eRing, &pCompletion );
+          if ( iResult == -EINTR ) { continue; }
+          if ( iResult < 0 ) { break; }
+          complete( pCompletion );
+        }
+        io_uring_queue_exit( &m_eRing );
+        m_bRing          = false;
+        m_iBytesInFlight = 0;
+        readBlocks( iFile, iSubmit, iEnd );
+        return;
+      }
+      complete( pCompletion );
+    }
+    return;
+  }
+#endif
+  for ( uint64_t iPosition = iBegin; iPosition < iEnd; iPosition += g_iBlockSize ) {
+    const size_t  iLength = static_cast<size_t>( ( std::min )( g_iBlockSize, iEnd - iPosition ) );
+    const ssize_t iRead   = pread( iFile, m_pBuffer.data(), iLength, static_cast<off_t>( iPosition ) );
+    if ( iRead <= 0 ) { break; }
+    m_iBytesRead += static_cast<uint64_t>( iRead );
+  }
+}
+#endif
@@ -7,9 +7,11 @@
 #include "PccRendererObjectPointcloud.h"
 #include "PccRendererObjectMesh.h"
 #include "PccRendererPrimitive.h"
+#include "PccRendererCacheDirectory.h"
 
 Sequence::Sequence() {}
 Sequence::~Sequence() {
+  stopPrefetch();
   m_eObject.clear();
   m_eObjectSrc.clear();
   m_pTypeName.clear();
@@ -27,16 +29,7 @@ bool Sequence::check() {
   return true;
 }
 
-Object& Sequence::getObject() {
-  auto& eObject   = m_bDisplaySource && m_eObjectSrc.size() > 0 ? m_eObjectSrc : m_eObject;
-  int   iNumFrame = getNumFrames();
-  if ( m_iFrameIndex < 0 && m_iFrameIndex > iNumFrame ) {
-    printf( "Error: can't load object of frame index = %d is not in [%d;%d] \n", m_iFrameIndex, 0, iNumFrame );
-    exit( -1 );
-  }
-  return *eObject[m_bPlayBackward && m_iFrameIndex >= (int)m_eObject.size() ? iNumFrame - 1 - m_iFrameIndex
-                                                                            : m_iFrameIndex];
-}
+Object& Sequence::getObject() { return getObject( m_iFrameIndex ); }
 
 Object& Sequence::getObject( int iIndex ) {
   auto& eObject   = m_bDisplaySource && m_eObjectSrc.size() > 0 ? m_eObjectSrc : m_eObject;
@@ -45,31 +38,362 @@ Object& Sequence::getObject( int iIndex ) {
     printf( "Error: can't load object of frame index = %d is not in [%d;%d] \n", iIndex, 0, iNumFrame );
     exit( -1 );
   }
-  return *eObject[m_bPlayBackward && iIndex >= (int)m_eObject.size() ? iNumFrame - 1 - iIndex : iIndex];
+  int iObjectIndex = getObjectIndex( iIndex );
+  if ( m_eThread.joinable() ) {
+    std::unique_lock<std::mutex> eLock( m_eMutex );
+    waitObject( iObjectIndex, eLock );
+  }
+  return *eObject[iObjectIndex];
+}
+
+int Sequence::getFrameNode( int iIndex ) {
+  return PointMemory::getInstance().getFrameNode( getObjectIndex( iIndex ), static_cast<int>( m_eObject.size() ) );
+}
+
+int Sequence::getObjectIndex( int iIndex ) {
+  return m_bPlayBackward && iIndex >= (int)m_eObject.size() ? getNumFrames() - 1 - iIndex : iIndex;
+}
+
+void Sequence::setFrameIndex( int32_t iFrameIndex ) {
+  m_iFrameIndex = iFrameIndex;
+  if ( m_eThread.joinable() ) {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    m_iCursor = iFrameIndex;
+    m_eCursorChanged.notify_one();
+  }
+}
+
+Object& Sequence::acquireObject( int iIndex ) {
+  if ( m_eThread.joinable() ) {
+    std::unique_lock<std::mutex> eLock( m_eMutex );
+    m_iCursor = iIndex;
+    m_pPinned[getObjectIndex( iIndex )]++;
+    waitObject( getObjectIndex( iIndex ), eLock );
+  }
+  return getObject( iIndex );
+}
+
+void Sequence::releaseObject( int iIndex ) {
+  if ( m_eThread.joinable() ) {
+    std::lock_guard<std::mutex> eLock( m_eMutex );
+    m_pPinned[getObjectIndex( iIndex )]--;
+    m_eCursorChanged.notify_one();
+  }
+}
+
+void Sequence::waitObject( int iObjectIndex, std::unique_lock<std::mutex>& eLock ) {
+  if ( !m_pResident[iObjectIndex] ) {
+    m_pPinned[iObjectIndex]++;
+    m_eCursorChanged.notify_one();
+    m_eObjectLoaded.wait( eLock, [&] { return m_pResident[iObjectIndex] != 0; } );
+    m_pPinned[iObjectIndex]--;
+  }
+}
+
+void Sequence::startPrefetch() {
+  if ( !getStreaming() || m_eObject.empty() || m_eThread.joinable() ) { return; }
+  if ( getObjectType() != ObjectType::POINTCLOUD ) {
+    printf( "Streaming: only point cloud sequences can be streamed, all the frames are kept in memory \n" );
+    m_iMemoryBudget = 0;
+    return;
+  }
+  size_t iTotalSize = 0;
+  m_pFrameSize.assign( m_eObject.size(), 0 );
+  for ( size_t i = 0; i < m_eObject.size(); i++ ) {
+    m_pFrameSize[i] = m_pFrameSource[i].m_iSize + ( i < m_pFrameSourceSrc.size() ? m_pFrameSourceSrc[i].m_iSize : 0 );
+    iTotalSize += m_pFrameSize[i];
+  }
+  m_pResident.assign( m_eObject.size(), 0 );
+  m_pPinned.assign( m_eObject.size(), 0 );
+  m_iCursor       = m_iFrameIndex;
+  m_bStopPrefetch = false;
+  printf( "Streaming: memory budget = %zu MB for %zu frames of %zu MB \n", m_iMemoryBudget >> 20, m_eObject.size(),
+          iTotalSize >> 20 );
+  if ( m_iCompressedBudget > 0 ) {
+    printf( "Streaming: %zu MB of compressed frames in memory, budget = %zu MB \n", m_iCompressedSize >> 20,
+            m_iCompressedBudget >> 20 );
+  }
+  m_eThread = std::thread( &Sequence::prefetch, this );
+}
+
+void Sequence::stopPrefetch() {
+  if ( m_eThread.joinable() ) {
+    {
+      std::lock_guard<std::mutex> eLock( m_eMutex );
+      m_bStopPrefetch = true;
+      m_eCursorChanged.notify_one();
+    }
+    m_eThread.join();
+    if ( m_iIoPrefetch > 0 ) { Prefetcher::getInstance().printStats(); }
+  }
+}
+
+void Sequence::loadObject( int iObjectIndex, std::vector<std::string>& pTypeName ) {
+  PreferredNode eNode( getFrameNode( iObjectIndex ) );
+  for ( int iSource = 0; iSource < 2; iSource++ ) {
+    auto& eObject      = iSource ? m_eObjectSrc : m_eObject;
+    auto& pFrameSource = iSource ? m_pFrameSourceSrc : m_pFrameSource;
+    if ( iObjectIndex >= static_cast<int>( eObject.size() ) ) { continue; }
+    auto& eSource = pFrameSource[iObjectIndex];
+    auto  pObject = ( std::dynamic_pointer_cast<ObjectPointcloud> )( eObject[iObjectIndex] );
+    if ( eSource.m_sFilename.empty() ) { continue; }
+    auto& pCompressed = iSource ? m_pCompressedSrc : m_pCompressed;
+    if ( iObjectIndex < static_cast<int>( pCompressed.size() ) && !pCompressed[iObjectIndex].empty() &&
+         pObject->decompress( pCompressed[iObjectIndex] ) ) {
+      continue;
+    }
+    if ( readFrame( *pObject, eSource, pTypeName ) ) { storeCompressed( *pObject, iObjectIndex, iSource != 0 ); }
+    eSource.m_iSize = pObject->getMemorySize();
+  }
+}
+
+//! Keep a compressed copy of a frame if the compressed frames fit in their budget. Called by the tasks of the read
+//! and by the prefetch thread, once the read is complete.
+void Sequence::storeCompressed( ObjectPointcloud& eObject, int iObjectIndex, bool bSource ) {
+  if ( m_iCompressedBudget == 0 || m_bCompressedFull ) { return; }
+  std::vector<uint8_t> pBuffer;
+  eObject.compress( pBuffer );
+#pragma omp critical( storeCompressed )
+  {
+    auto& pCompressed = bSource ? m_pCompressedSrc : m_pCompressed;
+    if ( m_iCompressedSize + pBuffer.size() > m_iCompressedBudget ) {
+      if ( !m_bCompressedFull ) {
+        printf( "Streaming: compressed frames budget reached (%zu MB), the next frames are read from the files \n",
+                m_iCompressedSize >> 20 );
+      }
+      m_bCompressedFull = true;
+    } else {
+      if ( iObjectIndex >= static_cast<int>( pCompressed.size() ) ) { pCompressed.resize( iObjectIndex + 1 ); }
+      if ( pCompressed[iObjectIndex].empty() ) {
+        m_iCompressedSize += pBuffer.size();
+        pCompressed[iObjectIndex].swap( pBuffer );
+      }
+    }
+  }
+}
+
+void Sequence::clearCompressed() {
+  for ( auto& pBuffer : m_pCompressed ) { std::vector<uint8_t>().swap( pBuffer ); }
+  for ( auto& pBuffer : m_pCompressedSrc ) { std::vector<uint8_t>().swap( pBuffer ); }
+  m_iCompressedSize = 0;
+  m_bCompressedFull = false;
 }
 
-const std::string& Sequence::getFilename() { return getObject().getFilename(); }
-void               Sequence::load() { getObject().load(); }
+bool Sequence::readFrame( ObjectPointcloud& eObject, const FrameSource& eSource, std::vector<std::string>& pTypeName ) {
+  eObject.setAttributes( m_iAttributes );
+  eObject.setQuantization( m_iQuantization );
+  if ( eSource.m_pContainer ) { return eObject.readContainer( *eSource.m_pContainer, eSource.m_iFrameIndex ); }
+  pTypeName.clear();
+  return eObject.read( eSource.m_sFilename, eSource.m_iFrameIndex, eSource.m_bBinary, m_iDropDups, m_bMortonOrder,
+                       pTypeName );
+}
+
+//! Add the file ranges read by loadObject() to the prefetch requests.
+void Sequence::addRequests( int iObjectIndex, std::vector<Prefetcher::Request>& pRequests ) {
+  for ( int iSource = 0; iSource < 2; iSource++ ) {
+    auto& pFrameSource = iSource ? m_pFrameSourceSrc : m_pFrameSource;
+    if ( iObjectIndex >= static_cast<int>( pFrameSource.size() ) ) { continue; }
+    auto& eSource = pFrameSource[iObjectIndex];
+    if ( eSource.m_sFilename.empty() ) { continue; }
+    Prefetcher::Request eRequest;
+    if ( eSource.m_pContainer ) {
+      const auto& eFrame   = eSource.m_pContainer->getFrame( eSource.m_iFrameIndex );
+      eRequest.m_sFilename = eSource.m_sFilename;
+      eRequest.m_iOffset   = eFrame.m_iOffset;
+      eRequest.m_iSize     = eFrame.m_iSize;
+    } else {
+      eRequest.m_sFilename = createFilename( eSource.m_sFilename, eSource.m_iFrameIndex );
+      std::string sBinary =
+          CacheDirectory::getInstance().getBinaryName( eRequest.m_sFilename, m_iDropDups, m_bMortonOrder );
+      if ( eSource.m_bBinary && exist( sBinary ) ) { eRequest.m_sFilename = sBinary; }
+    }
+    pRequests.push_back( eRequest );
+  }
+}
 
-void Sequence::unload() {
-  for ( auto& eObject : m_eObject ) { eObject->unload(); }
-  for ( auto& eObject : m_eObjectSrc ) { eObject->unload(); }
+void Sequence::requestAttributes( uint8_t iAttributes ) {
+  if ( ( iAttributes & ~m_iAttributes ) == 0 || m_eObject.empty() || getObjectType() != ObjectType::POINTCLOUD ) {
+    return;
+  }
+  m_iAttributes |= iAttributes;
+  printf( "READER: read the attributes %d of the point clouds \n", m_iAttributes );
+  if ( m_eThread.joinable() ) {
+    // Streaming mode: the resident frames are released and read again by the prefetch thread.
+    stopPrefetch();
+    clearCompressed();
+    for ( auto& eObject : m_eObject ) { ( std::dynamic_pointer_cast<ObjectPointcloud> )( eObject )->release(); }
+    for ( auto& eObject : m_eObjectSrc ) { ( std::dynamic_pointer_cast<ObjectPointcloud> )( eObject )->release(); }
+    startPrefetch();
+    return;
+  }
+  // The frames are read again in temporary objects and only the missing attributes are moved: the positions and the
+  // GPU buffers are kept. A shared object is completed by its first frame, then the other frames that share it are
+  // read again and get their own object if their attributes differ.
+  for ( int iSource = 0; iSource < 2; iSource++ ) {
+    auto&                  eObject      = iSource ? m_eObjectSrc : m_eObject;
+    auto&                  pFrameSource = iSource ? m_pFrameSourceSrc : m_pFrameSource;
+    std::map<Object*, int> pFirst;
+    std::vector<int>       pShared( eObject.size(), -1 );
+    std::vector<uint8_t>   pUpdated( eObject.size(), 0 );
+    for ( int i = 0; i < static_cast<int>( eObject.size() ); i++ ) {
+      auto it = pFirst.emplace( eObject[i].get(), i ).first;
+      if ( it->second != i ) { pShared[i] = it->second; }
+    }
+    for ( int iPass = 0; iPass < 2; iPass++ ) {
+      runTasks( static_cast<int>( eObject.size() ), [&]( int i ) {
+        if ( ( iPass == 0 ) != ( pShared[i] < 0 ) || ( iPass == 1 && !pUpdated[pShared[i]] ) ||
+             pFrameSource[i].m_sFilename.empty() ) {
+          return;
+        }
+        PreferredNode eNode( getFrameNode( i ) );
+        auto pObject = ( std::dynamic_pointer_cast<ObjectPointcloud> )( iPass ? eObject[pShared[i]] : eObject[i] );
+        if ( iPass == 0 && ( pObject->getSkippedAttributes() & iAttributes ) == 0 ) { return; }
+        auto                     pFrame = std::make_shared<ObjectPointcloud>();
+        std::vector<std::string> pTypeName;
+        if ( !readFrame( *pFrame, pFrameSource[i], pTypeName ) ) { return; }
+        if ( iPass == 0 ) {
+          pUpdated[i] = pObject->copyAttributes( *pFrame );
+        } else if ( !pObject->isSameContent( *pFrame ) ) {
+          pFrame->setModel( pObject->getModel() );
+          eObject[i] = pFrame;
+        }
+      } );
+    }
+  }
+}
+
+void Sequence::prefetch() {
+  std::vector<std::string>         pTypeName;
+  std::vector<uint8_t>             pKeep;
+  std::vector<int>                 pWanted;
+  std::vector<Prefetcher::Request> pRequests;
+  std::unique_lock<std::mutex>     eLock( m_eMutex );
+  while ( !m_bStopPrefetch ) {
+    // Frames to keep: the pinned frames then the frames following the cursor in playback order within the budget.
+    size_t iSize = 0;
+    pKeep.assign( m_eObject.size(), 0 );
+    pWanted.clear();
+    for ( size_t i = 0; i < m_eObject.size(); i++ ) {
+      if ( m_pPinned[i] > 0 ) {
+        pKeep[i] = 1;
+        pWanted.push_back( static_cast<int>( i ) );
+        iSize += m_pFrameSize[i];
+      }
+    }
+    for ( int k = 0, iNumFrames = getNumFrames(); k < iNumFrames; k++ ) {
+      int i = getObjectIndex( ( m_iCursor + k ) % iNumFrames );
+      if ( pKeep[i] ) { continue; }
+      if ( k > 0 && iSize + m_pFrameSize[i] > m_iMemoryBudget ) { break; }
+      pKeep[i] = 1;
+      pWanted.push_back( i );
+      iSize += m_pFrameSize[i];
+    }
+    // Evict the frames behind the cursor, then load the first missing frame.
+    for ( size_t i = 0; i < m_eObject.size(); i++ ) {
+      if ( m_pResident[i] && !pKeep[i] ) {
+        m_pResident[i] = 0;
+        eLock.unlock();
+        ( std::dynamic_pointer_cast<ObjectPointcloud> )( m_eObject[i] )->release();
+        if ( i < m_eObjectSrc.size() ) { ( std::dynamic_pointer_cast<ObjectPointcloud> )( m_eObjectSrc[i] )->release(); }
+        eLock.lock();
+      }
+    }
+    auto it = std::find_if( pWanted.begin(), pWanted.end(), [&]( int i ) { return m_pResident[i] == 0; } );
+    if ( it == pWanted.end() ) {
+      m_eCursorChanged.wait( eLock );
+      continue;
+    }
+    int iObjectIndex = *it;
+    eLock.unlock();
+    // The next missing frames are read asynchronously while this frame is decoded.
+    if ( m_iIoPrefetch > 0 ) {
+      pRequests.clear();
+      int iNumFrames = 0;
+      for ( auto itNext = it + 1; itNext != pWanted.end() && iNumFrames < m_iIoPrefetch; itNext++, iNumFrames++ ) {
+        if ( !m_pResident[*itNext] ) { addRequests( *itNext, pRequests ); }
+      }
+      Prefetcher::getInstance().prefetch( pRequests );
+    }
+    loadObject( iObjectIndex, pTypeName );
+    eLock.lock();
+    m_pFrameSize[iObjectIndex] = m_pFrameSource[iObjectIndex].m_iSize;
+    if ( iObjectIndex < static_cast<int>( m_pFrameSourceSrc.size() ) ) {
+      m_pFrameSize[iObjectIndex] += m_pFrameSourceSrc[iObjectIndex].m_iSize;
+    }
+    m_pResident[iObjectIndex] = 1;
+    m_eObjectLoaded.notify_all();
+  }
+}
+
+// The name of the file of the current frame is given by its source: a shared frame keeps the name of the first file
+// read with its content. The frames without source, as the meshes, give their name.
+std::string Sequence::getFilename() {
+  auto&     pFrameSource = m_bDisplaySource && m_eObjectSrc.size() > 0 ? m_pFrameSourceSrc : m_pFrameSource;
+  const int iObjectIndex = getObjectIndex( m_iFrameIndex );
+  if ( iObjectIndex < 0 || iObjectIndex >= static_cast<int>( pFrameSource.size() ) ||
+       pFrameSource[iObjectIndex].m_sFilename.empty() ) {
+    return getObject().getFilename();
+  }
+  const auto& eSource = pFrameSource[iObjectIndex];
+  if ( eSource.m_pContainer ) { return stringFormat( "%s:%d", eSource.m_sFilename.c_str(), eSource.getFrameIndex() ); }
+  return createFilename( eSource.m_sFilename, eSource.m_iFrameIndex );
+}
+
+void Sequence::load() { getObject().load(); }
+
+void Sequence::unload( bool bKeepCurrent ) {
+  // The frames shared with the current frame keep its GPU buffers when the display options have not changed.
+  const Object* pCurrent = bKeepCurrent ? &getObject() : nullptr;
+  for ( auto& eObject : m_eObject ) {
+    if ( eObject.get() != pCurrent ) { eObject->unload(); }
+  }
+  for ( auto& eObject : m_eObjectSrc ) {
+    if ( eObject.get() != pCurrent ) { eObject->unload(); }
+  }
+}
+
+//! Model matrix that moves the reference box to the origin and scales it to the box size.
+static Mat4 getScaleMatrix( Box eReference, float fBoxSize ) {
+  if ( fBoxSize == 0.f ) {
+    printf( "Sequence: ignore scale to box of size 0\n" );
+    return Mat4( 1.f );
+  }
+  const float fScale = fBoxSize / eReference.getMaxSize();
+  return glm::scale( Vec3( fScale, fScale, fScale ) ) * glm::translate( -eReference.min() );
+}
+
+//! Model matrix that moves the center of the reference box to the center of the box size.
+static Mat4 getCenterMatrix( Box eReference, float fBoxSize ) {
+  return glm::translate( Vec3( fBoxSize / 2.f ) - eReference.center() );
 }
 
 void Sequence::normalize( int32_t iScaleMode, bool bCenter ) {
   printf( "Normalize sequence size and position according to %f bounding box (scale = %d center = %d)\n", m_fBoxSize,
           iScaleMode, bCenter );
   printBoundingBox( "ORG" );
+  // The normalization is the model matrix of the objects, applied by the shaders and the software renderer: the
+  // points are not modified and the bounding boxes are transformed directly, whether the frames are resident or not.
+  const Box eBoxOrg = m_eBox;
+  for ( int iSource = 0; iSource < 2; iSource++ ) {
+    for ( auto& eObject : iSource ? m_eObjectSrc : m_eObject ) {
+      eObject->setModel( iScaleMode != 0 ? getScaleMatrix( iScaleMode == 1 ? eObject->getBox() : eBoxOrg, m_fBoxSize )
+                                         : Mat4( 1.f ) );
+    }
+  }
   if ( iScaleMode != 0 ) {
-    for ( auto& eObject : m_eObject ) { eObject->scale( iScaleMode == 1 ? eObject->getBox() : m_eBox, m_fBoxSize ); }
-    for ( auto& eObject : m_eObjectSrc ) { eObject->scale( iScaleMode == 1 ? eObject->getBox() : m_eBox, m_fBoxSize ); }
-    recomputeBoundingBox();
+    updateBoundingBox();
     printBoundingBox( "SCA" );
   }
   if ( bCenter ) {
-    for ( auto& eObject : m_eObject ) { eObject->center( m_eBox, m_fBoxSize ); }
-    for ( auto& eObject : m_eObjectSrc ) { eObject->center( m_eBox, m_fBoxSize ); }
-    recomputeBoundingBox();
+    // The shared frames are moved once.
+    const Mat4        eCenter = getCenterMatrix( m_eBox, m_fBoxSize );
+    std::set<Object*> pMoved;
+    for ( int iSource = 0; iSource < 2; iSource++ ) {
+      for ( auto& eObject : iSource ? m_eObjectSrc : m_eObject ) {
+        if ( pMoved.insert( eObject.get() ).second ) { eObject->setModel( eCenter * eObject->getModel() ); }
+      }
+    }
+    updateBoundingBox();
     printBoundingBox( "CEN" );
   }
 }
@@ -87,11 +411,18 @@ void Sequence::recomputeBoundingBox() {
     m_eBox = Box();
     for ( auto& pObject : m_eObject ) {
       pObject->recomputeBoundingBox();
-      m_eBox.update( pObject->getBox() );
+      m_eBox.update( pObject->getModelBox() );
     }
   }
 }
 
+void Sequence::updateBoundingBox() {
+  if ( static_cast<int>( m_eObject.size() ) > 0 ) {
+    m_eBox = Box();
+    for ( auto& pObject : m_eObject ) { m_eBox.update( pObject->getModelBox() ); }
+  }
+}
+
 void Sequence::add( std::shared_ptr<Object> pObject, bool bSource ) {
   m_eBox.update( pObject->getBox() );
   ( bSource ? m_eObjectSrc : m_eObject ).push_back( pObject );
@@ -104,16 +435,93 @@ void Sequence::readDirectory( const std::string& sDir, int iFrameNumber, bool eB
     if ( ( bSource ? m_eObjectSrc : m_eObject ).size() == 0 ) {
       readDirectory( sDir, "obj", iFrameNumber, eBinaryFile, bSource );
     }
-    if ( bSource && m_eObject.size() == m_eObjectSrc.size() ) {
-      for ( size_t i = 0; i < m_eObject.size(); i++ ) {
-        m_eObject[i]->setSource( m_eObjectSrc[i].get() );
-        m_eObjectSrc[i]->setSource( m_eObject[i].get() );
-      }
-    }
     printf("Source read object size = %zu and %zu \n",m_eObject.size(),m_eObjectSrc.size());
   }
 }
 
+void Sequence::read( const std::string& sFile,
+                     const std::string& sDir,
+                     const std::string& sFileSrc,
+                     const std::string& sDirSrc,
+                     int                iFrameIndex,
+                     int                iFrameNumber,
+                     bool               bBinary ) {
+  // The sequence and the source sequence are read by two tasks and each frame is a sub-task, the chunks of the large
+  // frames being sub-tasks of the frame: the idle threads steal the pending tasks of all the inputs.
+  // The identical frames are shared when the frames stay resident and are not paired with the frames of a source.
+  m_bShareFrames = !getStreaming() && sFileSrc.empty() && sDirSrc.empty();
+  runTasks( 2, [&]( int iSource ) {
+    readFile( iSource ? sFileSrc : sFile, iFrameIndex, iFrameNumber, bBinary, iSource != 0 );
+    readDirectory( iSource ? sDirSrc : sDir, iFrameNumber, bBinary, iSource != 0 );
+  } );
+  if ( m_bShareFrames ) {
+    std::set<Object*> pDistinct;
+    for ( auto& pObject : m_eObject ) { pDistinct.insert( pObject.get() ); }
+    if ( pDistinct.size() < m_eObject.size() ) {
+      printf( "READER: the %zu frames share the points and the GPU buffers of %zu distinct frames \n", m_eObject.size(),
+              pDistinct.size() );
+    }
+    m_pSharedFrames.clear();
+    m_bShareFrames = false;
+  }
+  for ( auto& pObject : m_eObject ) { m_eBox.update( pObject->getBox() ); }
+  for ( auto& pObject : m_eObjectSrc ) { m_eBox.update( pObject->getBox() ); }
+  if ( !m_eObjectSrc.empty() && m_eObject.size() == m_eObjectSrc.size() ) {
+    for ( size_t i = 0; i < m_eObject.size(); i++ ) {
+      m_eObject[i]->setSource( m_eObjectSrc[i].get() );
+      m_eObjectSrc[i]->setSource( m_eObject[i].get() );
+    }
+  }
+}
+
+//! Replace a frame by an identical frame already read, the duplicate is released. The lookup, the comparison and the
+//! registration are done in the same critical section: the identical frames read at the same time by several threads
+//! are shared too. The hash is computed outside, the contents are only compared when the hashes are equal.
+void Sequence::shareFrame( std::vector<std::shared_ptr<Object> >& eObject, int iIndex ) {
+  auto           pObject = ( std::dynamic_pointer_cast<ObjectPointcloud> )( eObject[iIndex] );
+  const uint64_t iHash   = pObject->getContentHash();
+#pragma omp critical( shareFrame )
+  {
+    auto eRange = m_pSharedFrames.equal_range( iHash );
+    auto it     = eRange.first;
+    while ( it != eRange.second && !it->second->isSameContent( *pObject ) ) { it++; }
+    if ( it != eRange.second ) {
+      eObject[iIndex] = it->second;
+    } else {
+      m_pSharedFrames.emplace( iHash, pObject );
+    }
+  }
+}
+
+//! Keep the point types of the first frame that defines them, called in a critical section.
+void Sequence::addTypeName( SequenceIndex& eIndex, const std::vector<std::string>& pTypeName ) {
+  if ( pTypeName.empty() ) { return; }
+  if ( eIndex.getTypeName().empty() ) { eIndex.getTypeName() = pTypeName; }
+  if ( m_pTypeName.empty() ) { m_pTypeName = pTypeName; }
+}
+
+bool Sequence::readIndex( SequenceIndex&                  eIndex,
+                          const std::string&              sIndexName,
+                          const std::vector<std::string>& pFilenames,
+                          bool                            bSource ) {
+  if ( !eIndex.read( sIndexName, m_iDropDups ) ) { return false; }
+  std::vector<const SequenceIndex::Frame*> pFrames( pFilenames.size(), nullptr );
+  for ( size_t i = 0; i < pFilenames.size(); i++ ) {
+    if ( ( pFrames[i] = eIndex.find( pFilenames[i] ) ) == nullptr ) { return false; }
+  }
+  auto& eObject      = bSource ? m_eObjectSrc : m_eObject;
+  auto& pFrameSource = bSource ? m_pFrameSourceSrc : m_pFrameSource;
+  for ( size_t i = 0; i < pFrames.size(); i++ ) {
+    eObject[i]->getBox()    = pFrames[i]->m_eBox;
+    pFrameSource[i].m_iSize = pFrames[i]->getMemorySize( m_iAttributes );
+  }
+#pragma omp critical
+  if ( m_pTypeName.empty() ) { m_pTypeName = eIndex.getTypeName(); }
+  CacheDirectory::getInstance().touch( sIndexName );
+  printf( "READER: %zu frames initialized from the index %s \n", pFrames.size(), sIndexName.c_str() );
+  return true;
+}
+
 #if MSVC
 #include <windows.h>
 void Sequence::getFileInDirector( std::string               sDirector,
@@ -121,11 +529,11 @@ void Sequence::getFileInDirector( std::string               sDirector,
                                   std::vector<std::string>& eFileLists ) {
   WIN32_FIND_DATA eSearchData;
   memset( &eSearchData, 0, sizeof( WIN32_FIND_DATA ) );
-  std::string eString = sDirector + std::string( "\\*." ) + sExtension;
+  std::string eString = sDirector + std::string( "\\*" );
   HANDLE      eHandle = FindFirstFile( eString.c_str(), &eSearchData );
   while ( eHandle != INVALID_HANDLE_VALUE ) {
     std::string eFile = std::string( eSearchData.cFileName );
-    if ( eFile.substr( eFile.find_last_of( "." ) ).compare( "." + sExtension ) == 0 ) { eFileLists.push_back( eFile ); }
+    if ( getContentExtension( eFile ) == sExtension ) { eFileLists.push_back( eFile ); }
     if ( FindNextFile( eHandle, &eSearchData ) == FALSE ) { break; }
   }
   FindClose( eHandle );
@@ -142,9 +550,8 @@ void Sequence::getFileInDirector( std::string               sDirector,
   } else {
     struct dirent* pDirent;
     while ( ( pDirent = readdir( pDir ) ) != nullptr ) {
-      std::string eFile           = std::string( pDirent->d_name );
-      int         iIndexLastPoint = eFile.find_last_of( '.' );
-      if ( iIndexLastPoint != -1 && eFile.substr( iIndexLastPoint ) == "." + sExtension ) {
+      std::string eFile = std::string( pDirent->d_name );
+      if ( eFile.find_last_of( '.' ) != std::string::npos && getContentExtension( eFile ) == sExtension ) {
         eFileLists.push_back( eFile );
       }
     }
@@ -156,23 +563,59 @@ void Sequence::getFileInDirector( std::string               sDirector,
 
 void Sequence::readFile( const std::string& sFile, int iFrameIndex, int iFrameNumber, bool eBinaryFile, bool bSource ) {
   if ( !sFile.empty() ) {
-    std::string sExtension = getExtension( sFile );
+    std::string sExtension = getContentExtension( sFile );
     auto &eObject = bSource ? m_eObjectSrc : m_eObject;
+    if ( sExtension == "pcs" ) { readContainer( sFile, iFrameIndex, iFrameNumber, bSource ); }
     if ( sExtension == "ply" ) {
       int  iNumRead  = 0;
       bool bReadDone = false;
+      auto& pFrameSource = bSource ? m_pFrameSourceSrc : m_pFrameSource;
       for ( int i = 0; i < iFrameNumber; i++ ) {
         auto pObject = std::make_shared<ObjectPointcloud>();
+        pObject->setAttributes( m_iAttributes );
+        pObject->setQuantization( m_iQuantization );
         eObject.push_back( pObject );
       }
-#pragma omp parallel for
-      for ( int i = 0; i < iFrameNumber; i++ ) {
-        auto pObject = (std::dynamic_pointer_cast<ObjectPointcloud>)( eObject[i] );
-        if ( pObject->read( sFile, iFrameIndex + i, eBinaryFile, m_iDropDups, m_pTypeName ) ) {
-          bReadDone = true;
-          PROGRESSBAR( iNumRead, iFrameNumber, "Read Ply files %3d", iFrameIndex + iNumRead );
-          iNumRead++;
+      pFrameSource.resize( eObject.size() );
+      SequenceIndex            eIndex;
+      std::string              sIndexName = CacheDirectory::getInstance().getIndexName( sFile, m_iDropDups );
+      std::vector<std::string> pFilenames( iFrameNumber );
+      for ( int i = 0; i < iFrameNumber; i++ ) { pFilenames[i] = createFilename( sFile, iFrameIndex + i ); }
+      if ( eBinaryFile && getStreaming() && m_iQuantization == 0 &&
+           readIndex( eIndex, sIndexName, pFilenames, bSource ) ) {
+        for ( int i = 0; i < iFrameNumber; i++ ) {
+          pFrameSource[i].m_sFilename   = sFile;
+          pFrameSource[i].m_iFrameIndex = iFrameIndex + i;
+          pFrameSource[i].m_bBinary     = eBinaryFile;
         }
+        bReadDone = true;
+      } else {
+        runTasks( iFrameNumber, [&]( int i ) {
+          auto                     pObject = (std::dynamic_pointer_cast<ObjectPointcloud>)( eObject[i] );
+          std::vector<std::string> pTypeName;
+          // The points of the frame are allocated on the NUMA node of its range.
+          PreferredNode eNode( PointMemory::getInstance().getFrameNode( i, static_cast<int>( eObject.size() ) ) );
+          if ( pObject->read( sFile, iFrameIndex + i, eBinaryFile, m_iDropDups, m_bMortonOrder, pTypeName ) ) {
+            pFrameSource[i].m_sFilename   = sFile;
+            pFrameSource[i].m_iFrameIndex = iFrameIndex + i;
+            pFrameSource[i].m_bBinary     = eBinaryFile;
+            pFrameSource[i].m_iSize       = pObject->getMemorySize();
+#pragma omp critical
+            {
+              addTypeName( eIndex, pTypeName );
+              if ( eBinaryFile ) { eIndex.add( *pObject, pFilenames[i] ); }
+            }
+            if ( getStreaming() ) {
+              storeCompressed( *pObject, i, bSource );
+              pObject->release();
+            }
+            if ( m_bShareFrames ) { shareFrame( eObject, i ); }
+            bReadDone = true;
+            PROGRESSBAR( iNumRead, iFrameNumber, "Read Ply files %3d", iFrameIndex + iNumRead );
+            iNumRead++;
+          }
+        } );
+        if ( eBinaryFile && bReadDone ) { eIndex.write( sIndexName, m_iDropDups ); }
       }
       if ( !bReadDone ) { eObject.clear(); }
     }
@@ -183,25 +626,91 @@ void Sequence::readFile( const std::string& sFile, int iFrameIndex, int iFrameNu
         auto pObject = std::make_shared<ObjectMesh>();
         eObject.push_back( pObject );
       }
-#pragma omp parallel for
-      for ( int i = 0; i < iFrameNumber; i++ ) {
+      runTasks( iFrameNumber, [&]( int i ) {
         auto pObject = (std::dynamic_pointer_cast<ObjectMesh>)( eObject[i] );
         if ( pObject->read( sFile, iFrameIndex + i ) ) {
           bReadDone = true;
           PROGRESSBAR( iNumRead, iFrameNumber, "Read Ply files %3d", iFrameIndex + iNumRead );
           iNumRead++;
         }
-      }
+      } );
       if ( !bReadDone ) { eObject.clear(); }
     }
-    for ( auto& element : eObject ) { m_eBox.update( element->getBox() ); }
-    if ( bSource && m_eObject.size() == m_eObjectSrc.size() ) {
-      for ( size_t i = 0; i < m_eObject.size(); i++ ) {
-        m_eObject[i]->setSource( m_eObjectSrc[i].get() );
-        m_eObjectSrc[i]->setSource( m_eObject[i].get() );
-      }
+  }
+}
+
+void Sequence::readContainer( const std::string& sFile, int iFrameIndex, int iFrameNumber, bool bSource ) {
+  auto pContainer = std::make_shared<SequenceContainer>();
+  if ( !pContainer->open( sFile ) ) { return; }
+  auto& eObject      = bSource ? m_eObjectSrc : m_eObject;
+  auto& pFrameSource = bSource ? m_pFrameSourceSrc : m_pFrameSource;
+  // The frames are read from the first frame of the container with an index greater or equal to iFrameIndex.
+  size_t iFirst = 0;
+  while ( iFirst < pContainer->getNumFrames() && pContainer->getFrame( iFirst ).m_iFrameIndex < iFrameIndex ) {
+    iFirst++;
+  }
+  int iNumFrames = static_cast<int>( pContainer->getNumFrames() - iFirst );
+  if ( iFrameNumber > 0 ) { iNumFrames = ( std::min )( iNumFrames, iFrameNumber ); }
+  if ( pContainer->getDropDups() != m_iDropDups ) {
+    printf( "READER: %s has been created with dropdups = %d \n", sFile.c_str(), pContainer->getDropDups() );
+  }
+  // The main and the source inputs are read at the same time, as in readIndex().
+#pragma omp critical
+  if ( m_pTypeName.empty() ) { m_pTypeName = pContainer->getTypeName(); }
+  for ( int i = 0; i < iNumFrames; i++ ) { eObject.push_back( std::make_shared<ObjectPointcloud>() ); }
+  pFrameSource.resize( eObject.size() );
+  int iNumRead = 0;
+  runTasks( iNumFrames, [&]( int i ) {
+    auto pObject                  = ( std::dynamic_pointer_cast<ObjectPointcloud> )( eObject[i] );
+    pFrameSource[i].m_sFilename   = sFile;
+    pFrameSource[i].m_iFrameIndex = static_cast<int>( iFirst ) + i;
+    pFrameSource[i].m_iSize       = pContainer->getFrame( iFirst + i ).m_iMemorySize;
+    pFrameSource[i].m_pContainer  = pContainer;
+    // The points of the frame are allocated on the NUMA node of its range.
+    PreferredNode eNode( PointMemory::getInstance().getFrameNode( i, static_cast<int>( eObject.size() ) ) );
+    pObject->setAttributes( m_iAttributes );
+    if ( getStreaming() ) {
+      pObject->getBox() = pContainer->getFrameBox( iFirst + i );
+    } else if ( pObject->readContainer( *pContainer, iFirst + i ) ) {
+      if ( m_bShareFrames ) { shareFrame( eObject, i ); }
+      PROGRESSBAR( iNumRead, iNumFrames, "Read container frames %3d", iNumRead );
+      iNumRead++;
     }
+  } );
+  printf( "READER: %d frames of %s \n", iNumFrames, sFile.c_str() );
+}
+
+bool Sequence::writeContainer( const std::string& sFilename ) {
+  if ( m_eObject.empty() || getObjectType() != ObjectType::POINTCLOUD ) {
+    printf( "SequenceContainer: only point cloud sequences can be stored in a container \n" );
+    return false;
   }
+  SequenceContainer        eContainer;
+  std::vector<std::string> pTypeName;
+  if ( !eContainer.create( sFilename, m_iDropDups ) ) { return false; }
+  m_pFrameSource.resize( m_eObject.size() );
+  for ( int i = 0, iNumObjects = static_cast<int>( m_eObject.size() ); i < iNumObjects; i++ ) {
+    // The frames released in streaming mode and the frames read without all the attributes are read again, one at a
+    // time. The index of a shared frame is given by its source.
+    auto      pObject     = ( std::dynamic_pointer_cast<ObjectPointcloud> )( m_eObject[i] );
+    const int iFrameIndex = m_pFrameSource[i].m_sFilename.empty() ? pObject->getFrameIndex()
+                                                                  : m_pFrameSource[i].getFrameIndex();
+    bool      bLoad       = ( pObject->getNumPoints() == 0 || pObject->getSkippedAttributes() != 0 ) &&
+                     !m_pFrameSource[i].m_sFilename.empty();
+    if ( bLoad ) {
+      ObjectPointcloud eFrame;
+      uint8_t          iAttributes = m_iAttributes;
+      m_iAttributes                = ATTRIBUTE_ALL;
+      readFrame( eFrame, m_pFrameSource[i], pTypeName );
+      m_iAttributes = iAttributes;
+      if ( m_pTypeName.empty() ) { m_pTypeName = pTypeName; }
+      eContainer.add( eFrame, iFrameIndex );
+    } else {
+      eContainer.add( *pObject, iFrameIndex );
+    }
+    PROGRESSBAR( i, iNumObjects, "Write container frames %3d", i );
+  }
+  return eContainer.finish( m_eBox, m_pTypeName );
 }
 
 void Sequence::readDirectory( std::string pDirector,
@@ -229,19 +738,51 @@ void Sequence::readDirectory( std::string pDirector,
   if ( pExtension == "ply" ) {
     int  iNumRead  = 0;
     bool bReadDone = false;
+    auto& pFrameSource = bSource ? m_pFrameSourceSrc : m_pFrameSource;
     for ( int i = 0; i < iFrameNumber; i++ ) {
       auto pObject = std::make_shared<ObjectPointcloud>();
+      pObject->setAttributes( m_iAttributes );
+      pObject->setQuantization( m_iQuantization );
       eObject.push_back( pObject );
     }
-#pragma omp parallel for
-    for ( int i = 0; i < iFrameNumber; i++ ) {
-      std::string ePath   = std::string( pNewName ) + eFileLists[i];
-      auto        pObject = (std::dynamic_pointer_cast<ObjectPointcloud>)( eObject[i] );
-      if ( pObject->read( ePath, -1, bBinary, m_iDropDups, m_pTypeName ) ) {
-        bReadDone = true;
-        PROGRESSBAR( iNumRead, iFrameNumber, "Read Ply files %3d", iNumRead );
-        iNumRead++;
+    pFrameSource.resize( eObject.size() );
+    SequenceIndex            eIndex;
+    std::string              sIndexName =
+        CacheDirectory::getInstance().getIndexName( std::string( pNewName ) + "sequence", m_iDropDups );
+    std::vector<std::string> pFilenames( iFrameNumber );
+    for ( int i = 0; i < iFrameNumber; i++ ) { pFilenames[i] = std::string( pNewName ) + eFileLists[i]; }
+    if ( bBinary && getStreaming() && m_iQuantization == 0 && readIndex( eIndex, sIndexName, pFilenames, bSource ) ) {
+      for ( int i = 0; i < iFrameNumber; i++ ) {
+        pFrameSource[i].m_sFilename = pFilenames[i];
+        pFrameSource[i].m_bBinary   = bBinary;
       }
+      bReadDone = true;
+    } else {
+      runTasks( iFrameNumber, [&]( int i ) {
+        auto                     pObject = (std::dynamic_pointer_cast<ObjectPointcloud>)( eObject[i] );
+        std::vector<std::string> pTypeName;
+        // The points of the frame are allocated on the NUMA node of its range.
+        PreferredNode eNode( PointMemory::getInstance().getFrameNode( i, static_cast<int>( eObject.size() ) ) );
+        if ( pObject->read( pFilenames[i], -1, bBinary, m_iDropDups, m_bMortonOrder, pTypeName ) ) {
+          pFrameSource[i].m_sFilename = pFilenames[i];
+          pFrameSource[i].m_bBinary   = bBinary;
+          pFrameSource[i].m_iSize     = pObject->getMemorySize();
+#pragma omp critical
+          {
+            addTypeName( eIndex, pTypeName );
+            if ( bBinary ) { eIndex.add( *pObject, pFilenames[i] ); }
+          }
+          if ( getStreaming() ) {
+            storeCompressed( *pObject, i, bSource );
+            pObject->release();
+          }
+          if ( m_bShareFrames ) { shareFrame( eObject, i ); }
+          bReadDone = true;
+          PROGRESSBAR( iNumRead, iFrameNumber, "Read Ply files %3d", iNumRead );
+          iNumRead++;
+        }
+      } );
+      if ( bBinary && bReadDone ) { eIndex.write( sIndexName, m_iDropDups ); }
     }
     if ( !bReadDone ) { eObject.clear(); }
   }
@@ -252,15 +793,13 @@ void Sequence::readDirectory( std::string pDirector,
       auto pObject = std::make_shared<ObjectMesh>();
       eObject.push_back( pObject );
     }
-#pragma omp parallel for
-    for ( int i = 0; i < iFrameNumber; i++ ) {
+    runTasks( iFrameNumber, [&]( int i ) {
       auto        pObject = (std::dynamic_pointer_cast<ObjectMesh>)( eObject[i] );
       std::string ePath   = std::string( pNewName ) + eFileLists[i];
       if ( pObject->read( ePath, -1 ) ) {
         PROGRESSBAR( iNumRead, iFrameNumber, "Read obj files %3d", iNumRead );
         iNumRead++;
       }
-    }
+    } );
   }
-  for ( auto& element : eObject ) { m_eBox.update( element->getBox() ); }
 }
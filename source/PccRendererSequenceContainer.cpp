@@ -0,0 +1,177 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererSequenceContainer.h"
+#include "PccRendererObjectPointcloud.h"
+
+struct ContainerHeader {
+  char     m_pMagic[4];
+  uint32_t m_iVersion;
+  uint32_t m_iNumFrames;
+  int32_t  m_iDropDups;
+  uint64_t m_iTableOffset;
+  float    m_pBox[6];
+  uint64_t m_iTypeNameOffset;  // 0: no type names, otherwise offset of the names of the point types
+  uint8_t  m_pReserved[8];
+};
+static_assert( sizeof( ContainerHeader ) == 64, "ContainerHeader must have a fixed layout" );
+static_assert( sizeof( SequenceContainer::Frame ) == 64, "SequenceContainer::Frame must have a fixed layout" );
+
+static const char     g_pContainerMagic[4] = {'P', 'C', 'S', 'Q'};
+static const uint32_t g_iContainerVersion  = 1;
+static const uint64_t g_iContainerAlign    = 64;
+
+//! Names of the point types: their number then the length and the characters of each name.
+static bool readTypeName( const uint8_t*            pData,
+                          uint64_t                  iSize,
+                          uint64_t                  iOffset,
+                          std::vector<std::string>& pTypeName ) {
+  uint32_t iNumTypeName = 0, iLength = 0;
+  if ( iOffset + sizeof( uint32_t ) > iSize ) { return false; }
+  memcpy( &iNumTypeName, pData + iOffset, sizeof( uint32_t ) );
+  iOffset += sizeof( uint32_t );
+  if ( iNumTypeName > ( iSize - iOffset ) / sizeof( uint32_t ) ) { return false; }
+  pTypeName.resize( iNumTypeName );
+  for ( auto& sTypeName : pTypeName ) {
+    if ( iOffset + sizeof( uint32_t ) > iSize ) { return false; }
+    memcpy( &iLength, pData + iOffset, sizeof( uint32_t ) );
+    iOffset += sizeof( uint32_t );
+    if ( iOffset + iLength > iSize ) { return false; }
+    sTypeName.assign( reinterpret_cast<const char*>( pData ) + iOffset, iLength );
+    iOffset += iLength;
+  }
+  return true;
+}
+
+static void writeTypeName( std::ofstream& eOutput, const std::vector<std::string>& pTypeName ) {
+  uint32_t iNumTypeName = static_cast<uint32_t>( pTypeName.size() );
+  eOutput.write( reinterpret_cast<const char*>( &iNumTypeName ), sizeof( uint32_t ) );
+  for ( auto& sTypeName : pTypeName ) {
+    uint32_t iLength = static_cast<uint32_t>( sTypeName.size() );
+    eOutput.write( reinterpret_cast<const char*>( &iLength ), sizeof( uint32_t ) );
+    eOutput.write( sTypeName.data(), iLength );
+  }
+}
+
+SequenceContainer::SequenceContainer() {}
+SequenceContainer::~SequenceContainer() {}
+
+bool SequenceContainer::open( const std::string& sFilename ) {
+  m_sFilename = sFilename;
+  m_pFrames.clear();
+  if ( !m_eMemoryMap.open( sFilename, false ) || m_eMemoryMap.size() < sizeof( ContainerHeader ) ) {
+    printf( "SequenceContainer: can't open %s \n", sFilename.c_str() );
+    return false;
+  }
+  ContainerHeader eHeader;
+  memcpy( &eHeader, m_eMemoryMap.data(), sizeof( ContainerHeader ) );
+  if ( memcmp( eHeader.m_pMagic, g_pContainerMagic, sizeof( g_pContainerMagic ) ) != 0 ||
+       eHeader.m_iVersion != g_iContainerVersion ||
+       eHeader.m_iTableOffset + uint64_t( eHeader.m_iNumFrames ) * sizeof( Frame ) > m_eMemoryMap.size() ) {
+    printf( "SequenceContainer: %s is not a valid container \n", sFilename.c_str() );
+    m_eMemoryMap.close();
+    return false;
+  }
+  m_iDropDups = eHeader.m_iDropDups;
+  m_pTypeName.clear();
+  if ( eHeader.m_iTypeNameOffset > 0 && !readTypeName( m_eMemoryMap.data(), m_eMemoryMap.size(),
+                                                       eHeader.m_iTypeNameOffset, m_pTypeName ) ) {
+    printf( "SequenceContainer: %s is not a valid container \n", sFilename.c_str() );
+    m_eMemoryMap.close();
+    return false;
+  }
+  m_pFrames.resize( eHeader.m_iNumFrames );
+  memcpy( m_pFrames.data(), m_eMemoryMap.data() + eHeader.m_iTableOffset, m_pFrames.size() * sizeof( Frame ) );
+  for ( auto& eFrame : m_pFrames ) {
+    if ( eFrame.m_iOffset + eFrame.m_iSize > eHeader.m_iTableOffset ) {
+      printf( "SequenceContainer: %s is not a valid container \n", sFilename.c_str() );
+      m_pFrames.clear();
+      m_eMemoryMap.close();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SequenceContainer::create( const std::string& sFilename, int iDropDups ) {
+  ContainerHeader eHeader;
+  memset( &eHeader, 0, sizeof( ContainerHeader ) );
+  m_sFilename = sFilename;
+  m_iDropDups = iDropDups;
+  m_pFrames.clear();
+  m_eOutput.open( ( sFilename + ".tmp" ).c_str(), std::ios::binary | std::ios::out );
+  if ( !m_eOutput.is_open() ) {
+    printf( "SequenceContainer: can't create %s \n", sFilename.c_str() );
+    return false;
+  }
+  // The header is written by finish() once the offset of the frame table is known.
+  m_eOutput.write( reinterpret_cast<const char*>( &eHeader ), sizeof( ContainerHeader ) );
+  m_iOutputSize = sizeof( ContainerHeader );
+  return true;
+}
+
+static void writePadding( std::ofstream& eOutput, uint64_t& iOffset ) {
+  static const char pZero[g_iContainerAlign] = {0};
+  uint64_t          iPadding                 = ( g_iContainerAlign - iOffset % g_iContainerAlign ) % g_iContainerAlign;
+  eOutput.write( pZero, iPadding );
+  iOffset += iPadding;
+}
+
+bool SequenceContainer::add( ObjectPointcloud& eObject, int iFrameIndex ) {
+  if ( !m_eOutput.is_open() ) { return false; }
+  std::vector<uint8_t> pBuffer;
+  Frame                eFrame;
+  memset( &eFrame, 0, sizeof( Frame ) );
+  eObject.encodeBinary( pBuffer, m_iDropDups );
+  writePadding( m_eOutput, m_iOutputSize );
+  eFrame.m_iOffset     = m_iOutputSize;
+  eFrame.m_iSize       = pBuffer.size();
+  eFrame.m_iMemorySize = eObject.getMemorySize();
+  eFrame.m_iFrameIndex = iFrameIndex >= 0 ? iFrameIndex : int32_t( m_pFrames.size() );
+  eFrame.m_iNumPoints  = static_cast<uint32_t>( eObject.getNumPoints() );
+  for ( int i = 0; i < 3; i++ ) {
+    eFrame.m_pBox[i]     = eObject.getBox().min()[i];
+    eFrame.m_pBox[i + 3] = eObject.getBox().max()[i];
+  }
+  m_eOutput.write( reinterpret_cast<const char*>( pBuffer.data() ), pBuffer.size() );
+  m_iOutputSize += pBuffer.size();
+  m_pFrames.push_back( eFrame );
+  return static_cast<bool>( m_eOutput );
+}
+
+bool SequenceContainer::finish( Box eBox, const std::vector<std::string>& pTypeName ) {
+  if ( !m_eOutput.is_open() ) { return false; }
+  ContainerHeader eHeader;
+  memset( &eHeader, 0, sizeof( ContainerHeader ) );
+  writePadding( m_eOutput, m_iOutputSize );
+  memcpy( eHeader.m_pMagic, g_pContainerMagic, sizeof( g_pContainerMagic ) );
+  eHeader.m_iVersion     = g_iContainerVersion;
+  eHeader.m_iNumFrames   = static_cast<uint32_t>( m_pFrames.size() );
+  eHeader.m_iDropDups    = m_iDropDups;
+  eHeader.m_iTableOffset = m_iOutputSize;
+  for ( int i = 0; i < 3; i++ ) {
+    eHeader.m_pBox[i]     = eBox.min()[i];
+    eHeader.m_pBox[i + 3] = eBox.max()[i];
+  }
+  m_eOutput.write( reinterpret_cast<const char*>( m_pFrames.data() ), m_pFrames.size() * sizeof( Frame ) );
+  if ( !pTypeName.empty() ) {
+    eHeader.m_iTypeNameOffset = m_iOutputSize + m_pFrames.size() * sizeof( Frame );
+    writeTypeName( m_eOutput, pTypeName );
+  }
+  m_pTypeName = pTypeName;
+  m_eOutput.seekp( 0 );
+  m_eOutput.write( reinterpret_cast<const char*>( &eHeader ), sizeof( ContainerHeader ) );
+  m_eOutput.close();
+  std::string sTemporary = m_sFilename + ".tmp";
+#ifdef WIN32
+  if ( m_eOutput ) { std::remove( m_sFilename.c_str() ); }
+#endif
+  if ( !m_eOutput || std::rename( sTemporary.c_str(), m_sFilename.c_str() ) != 0 ) {
+    printf( "SequenceContainer: can't write %s \n", m_sFilename.c_str() );
+    std::remove( sTemporary.c_str() );
+    return false;
+  }
+  printf( "SequenceContainer: %zu frames written in %s \n", m_pFrames.size(), m_sFilename.c_str() );
+  return true;
+}
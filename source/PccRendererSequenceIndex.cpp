@@ -0,0 +1,164 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererSequenceIndex.h"
+#include "PccRendererObjectPointcloud.h"
+#include "PccRendererCacheDirectory.h"
+
+static const char     g_pIndexMagic[4] = {'P', 'C', 'S', 'I'};
+static const uint32_t g_iIndexVersion  = 1;
+
+size_t SequenceIndex::Frame::getMemorySize( uint8_t iAttributes ) const {
+  size_t iPointSize = sizeof( Point ) + ( m_bAlpha ? sizeof( Color4u8 ) : sizeof( Color3u8 ) ) +
+                      ( m_bNormal && ( iAttributes & ATTRIBUTE_NORMAL ) ? sizeof( Normal ) : 0 ) +
+                      ( m_bType && ( iAttributes & ATTRIBUTE_TYPE ) ? sizeof( uint8_t ) : 0 ) +
+                      ( iAttributes & ATTRIBUTE_MULTI_COLOR ? m_iNumMultiColors * sizeof( Color3u8 ) : 0 );
+  return static_cast<size_t>( m_iNumPoints ) * iPointSize;
+}
+
+SequenceIndex::SequenceIndex() {}
+SequenceIndex::~SequenceIndex() {}
+
+template <typename T>
+static inline void readValue( std::ifstream& file, T& value ) {
+  file.read( reinterpret_cast<char*>( &value ), sizeof( T ) );
+}
+
+template <typename T>
+static inline void writeValue( std::ofstream& file, const T& value ) {
+  file.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+static inline void readString( std::ifstream& file, std::string& sString ) {
+  uint32_t iLength = 0;
+  readValue( file, iLength );
+  if ( !file || iLength > 4096 ) {
+    file.setstate( std::ios::failbit );
+    return;
+  }
+  sString.resize( iLength );
+  file.read( &sString[0], iLength );
+}
+
+static inline void writeString( std::ofstream& file, const std::string& sString ) {
+  writeValue( file, static_cast<uint32_t>( sString.size() ) );
+  file.write( sString.data(), sString.size() );
+}
+
+bool SequenceIndex::read( const std::string& sFilename, int iDropDups ) {
+  std::ifstream file( sFilename.c_str(), std::ios::binary | std::ios::in );
+  if ( !file.is_open() ) { return false; }
+  char     pMagic[4];
+  uint32_t iVersion = 0, iNumFrames = 0, iNumTypeName = 0;
+  int32_t  iIndexDropDups = -1;
+  file.read( pMagic, sizeof( pMagic ) );
+  readValue( file, iVersion );
+  readValue( file, iIndexDropDups );
+  if ( !file || memcmp( pMagic, g_pIndexMagic, sizeof( pMagic ) ) != 0 || iVersion != g_iIndexVersion ||
+       iIndexDropDups != iDropDups ) {
+    return false;
+  }
+  readValue( file, iNumTypeName );
+  m_pTypeName.resize( iNumTypeName );
+  for ( auto& sTypeName : m_pTypeName ) { readString( file, sTypeName ); }
+  readValue( file, iNumFrames );
+  for ( uint32_t i = 0; i < iNumFrames && file; i++ ) {
+    Frame eFrame;
+    float pBox[6];
+    readString( file, eFrame.m_sFilename );
+    readValue( file, eFrame.m_iFileSize );
+    readValue( file, eFrame.m_iFileTime );
+    readValue( file, eFrame.m_iDataOffset );
+    readValue( file, eFrame.m_iNumPoints );
+    readValue( file, eFrame.m_iNumDuplicate );
+    readValue( file, eFrame.m_iNumMultiColors );
+    readValue( file, eFrame.m_iFormat );
+    readValue( file, eFrame.m_bAlpha );
+    readValue( file, eFrame.m_bNormal );
+    readValue( file, eFrame.m_bType );
+    file.read( reinterpret_cast<char*>( pBox ), sizeof( pBox ) );
+    eFrame.m_eBox = Box( Vec3( pBox[0], pBox[1], pBox[2] ), Vec3( pBox[3], pBox[4], pBox[5] ) );
+    m_eFrames[eFrame.m_sFilename] = eFrame;
+  }
+  if ( !file ) {
+    printf( "SequenceIndex: %s is not correct and will be recreated \n", sFilename.c_str() );
+    m_eFrames.clear();
+    m_pTypeName.clear();
+    return false;
+  }
+  return true;
+}
+
+bool SequenceIndex::write( const std::string& sFilename, int iDropDups ) {
+  std::string sDirectory = getDirectory( sFilename );
+  if ( !dirExists( sDirectory ) ) {
+#ifdef WIN32
+    CreateDirectory( sDirectory.c_str(), NULL );
+#else
+    mkdir( sDirectory.c_str(), 0777 );
+#endif
+  }
+  // The index is written in a temporary file then renamed, the readers of other processes never see partial files.
+  std::string   sTemporary = CacheDirectory::getTemporaryName( sFilename );
+  std::ofstream file( sTemporary.c_str(), std::ios::binary | std::ios::out );
+  if ( !file.is_open() ) { return false; }
+  file.write( g_pIndexMagic, sizeof( g_pIndexMagic ) );
+  writeValue( file, g_iIndexVersion );
+  writeValue( file, static_cast<int32_t>( iDropDups ) );
+  writeValue( file, static_cast<uint32_t>( m_pTypeName.size() ) );
+  for ( auto& sTypeName : m_pTypeName ) { writeString( file, sTypeName ); }
+  writeValue( file, static_cast<uint32_t>( m_eFrames.size() ) );
+  for ( auto& eElement : m_eFrames ) {
+    auto& eFrame  = eElement.second;
+    Box   eBox    = eFrame.m_eBox;
+    float pBox[6] = {eBox.min()[0], eBox.min()[1], eBox.min()[2], eBox.max()[0], eBox.max()[1], eBox.max()[2]};
+    writeString( file, eFrame.m_sFilename );
+    writeValue( file, eFrame.m_iFileSize );
+    writeValue( file, eFrame.m_iFileTime );
+    writeValue( file, eFrame.m_iDataOffset );
+    writeValue( file, eFrame.m_iNumPoints );
+    writeValue( file, eFrame.m_iNumDuplicate );
+    writeValue( file, eFrame.m_iNumMultiColors );
+    writeValue( file, eFrame.m_iFormat );
+    writeValue( file, eFrame.m_bAlpha );
+    writeValue( file, eFrame.m_bNormal );
+    writeValue( file, eFrame.m_bType );
+    file.write( reinterpret_cast<const char*>( pBox ), sizeof( pBox ) );
+  }
+  file.close();
+  if ( !file || std::rename( sTemporary.c_str(), sFilename.c_str() ) != 0 ) {
+    std::remove( sTemporary.c_str() );
+    printf( "SequenceIndex: can't write %s \n", sFilename.c_str() );
+    return false;
+  }
+  return true;
+}
+
+void SequenceIndex::add( ObjectPointcloud& eObject, const std::string& sFilename ) {
+  Frame eFrame;
+  if ( !getFileStatus( sFilename, eFrame.m_iFileSize, eFrame.m_iFileTime ) ) { return; }
+  eFrame.m_sFilename       = sFilename;
+  eFrame.m_iDataOffset     = eObject.getDataOffset();
+  eFrame.m_iFormat         = eObject.getFileFormat();
+  eFrame.m_iNumPoints      = static_cast<uint32_t>( eObject.getNumPoints() );
+  eFrame.m_iNumDuplicate   = static_cast<uint32_t>( eObject.getNumDuplicate() );
+  eFrame.m_iNumMultiColors = static_cast<uint32_t>( eObject.getRigParameters().getCount() );
+  eFrame.m_bAlpha          = eObject.getAlpha();
+  eFrame.m_bNormal         = eObject.getNormal() || ( eObject.getSkippedAttributes() & ATTRIBUTE_NORMAL );
+  eFrame.m_bType           = eObject.getHasType() || ( eObject.getSkippedAttributes() & ATTRIBUTE_TYPE );
+  eFrame.m_eBox            = eObject.getBox();
+  m_eFrames[sFilename]     = eFrame;
+}
+
+const SequenceIndex::Frame* SequenceIndex::find( const std::string& sFilename ) const {
+  auto it = m_eFrames.find( sFilename );
+  if ( it == m_eFrames.end() ) { return nullptr; }
+  uint64_t iSize = 0;
+  int64_t  iTime = 0;
+  if ( !getFileStatus( sFilename, iSize, iTime ) || iSize != it->second.m_iFileSize ||
+       iTime != it->second.m_iFileTime ) {
+    return nullptr;
+  }
+  return &it->second;
+}
@@ -8,125 +8,430 @@
 #include "PccRendererObjectMesh.h"
 #include "PccRendererObjectPointcloud.h"
 
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#define RASTER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define RASTER_TARGET( sTarget )
+#else
+#define RASTER_TARGET( sTarget ) __attribute__( ( target( sTarget ) ) )
+#endif
+#endif
+
+// The multiply-adds of the depths are not fused: the row rasterizers of all the cpus write the same depths.
+#if defined( __clang__ )
+#pragma STDC FP_CONTRACT OFF
+#define RASTER_EXACT
+#elif defined( __GNUC__ )
+#define RASTER_EXACT __attribute__( ( optimize( "fp-contract=off" ) ) )
+#else
+#define RASTER_EXACT
+#endif
+
+// The tiles of g_iTileSize x g_iTileSize pixels fit the depth and the colors of their pixels in the L2 cache, the
+// primitives are binned by chunks of g_iChunkSize primitives.
+static const int g_iTileSize  = 64;
+static const int g_iChunkSize = 1 << 14;
+
+// The faces are rasterized with edge functions in fixed point of g_iSubPixel sub-pixel positions. The faces of which
+// the vertices are in the guard band of +/- g_iGuardBand fixed point units around the tile area use 32-bit edge
+// functions evaluated by 16 (AVX-512), 8 (AVX2) or 1 pixel at a time, the others use the floating point equations.
+static const int     g_iSubPixel  = 16;
+static const int64_t g_iGuardBand = 1 << 14;
+static_assert( g_iTileSize <= 64, "the pixels of a row of a tile are returned in a 64-bit mask" );
+
+//! Edge functions of a face at the first pixel of a row and their steps, the depths of its vertices.
+struct Edges {
+  int32_t m_pW[3];
+  int32_t m_pStepX[3];
+  int32_t m_pStepY[3];
+  float   m_pDepth[3];
+  float   m_fInvArea;
+};
+
+//! Depth test and write of the iCount pixels of a row, returns the mask of the pixels to shade.
+typedef uint64_t ( *RasterRow )( const Edges& eEdges, float* pDepth, int iCount );
+
+RASTER_EXACT static uint64_t rasterRow( const Edges& eEdges, float* pDepth, int iCount ) {
+  const float depth0 = eEdges.m_pDepth[0] * eEdges.m_fInvArea, depth1 = eEdges.m_pDepth[1] * eEdges.m_fInvArea;
+  const float depth2 = eEdges.m_pDepth[2] * eEdges.m_fInvArea;
+  int32_t     w0 = eEdges.m_pW[0], w1 = eEdges.m_pW[1], w2 = eEdges.m_pW[2];
+  uint64_t    iMask = 0;
+  for ( int k = 0; k < iCount; k++ ) {
+    if ( ( w0 | w1 | w2 ) >= 0 ) {
+      const float d = ( depth0 * static_cast<float>( w0 ) + depth1 * static_cast<float>( w1 ) ) +
+                      depth2 * static_cast<float>( w2 );
+      if ( d < pDepth[k] ) {
+        pDepth[k] = d;
+        iMask |= uint64_t( 1 ) << k;
+      }
+    }
+    w0 += eEdges.m_pStepX[0];
+    w1 += eEdges.m_pStepX[1];
+    w2 += eEdges.m_pStepX[2];
+  }
+  return iMask;
+}
+
+#ifdef RASTER_X86
+RASTER_EXACT RASTER_TARGET( "avx2" )
+static uint64_t rasterRowAvx2( const Edges& eEdges, float* pDepth, int iCount ) {
+  const __m256i lane = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+  __m256i       w[3], step[3];
+  __m256        depth[3];
+  for ( int i = 0; i < 3; i++ ) {
+    const __m256i stepX = _mm256_set1_epi32( eEdges.m_pStepX[i] );
+    w[i]     = _mm256_add_epi32( _mm256_set1_epi32( eEdges.m_pW[i] ), _mm256_mullo_epi32( lane, stepX ) );
+    step[i]  = _mm256_slli_epi32( stepX, 3 );
+    depth[i] = _mm256_set1_ps( eEdges.m_pDepth[i] * eEdges.m_fInvArea );
+  }
+  uint64_t iMask = 0;
+  for ( int k = 0; k < iCount; k += 8 ) {
+    // The sign bit of w0 | w1 | w2 is set when the pixel is outside an edge.
+    const __m256i valid  = _mm256_cmpgt_epi32( _mm256_set1_epi32( iCount - k ), lane );
+    const __m256i inside = _mm256_andnot_si256(
+        _mm256_srai_epi32( _mm256_or_si256( _mm256_or_si256( w[0], w[1] ), w[2] ), 31 ), valid );
+    if ( !_mm256_testz_si256( inside, inside ) ) {
+      const __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( depth[0], _mm256_cvtepi32_ps( w[0] ) ),
+                                                     _mm256_mul_ps( depth[1], _mm256_cvtepi32_ps( w[1] ) ) ),
+                                      _mm256_mul_ps( depth[2], _mm256_cvtepi32_ps( w[2] ) ) );
+      const __m256  current = _mm256_maskload_ps( pDepth + k, inside );
+      const __m256i pass =
+          _mm256_and_si256( inside, _mm256_castps_si256( _mm256_cmp_ps( d, current, _CMP_LT_OQ ) ) );
+      _mm256_maskstore_ps( pDepth + k, pass, d );
+      iMask |= uint64_t( static_cast<uint32_t>( _mm256_movemask_ps( _mm256_castsi256_ps( pass ) ) ) ) << k;
+    }
+    for ( int i = 0; i < 3; i++ ) { w[i] = _mm256_add_epi32( w[i], step[i] ); }
+  }
+  return iMask;
+}
+
+RASTER_EXACT RASTER_TARGET( "avx512f" )
+static uint64_t rasterRowAvx512( const Edges& eEdges, float* pDepth, int iCount ) {
+  const __m512i lane = _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+  __m512i       w[3], step[3];
+  __m512        depth[3];
+  for ( int i = 0; i < 3; i++ ) {
+    const __m512i stepX = _mm512_set1_epi32( eEdges.m_pStepX[i] );
+    w[i]     = _mm512_add_epi32( _mm512_set1_epi32( eEdges.m_pW[i] ), _mm512_mullo_epi32( lane, stepX ) );
+    step[i]  = _mm512_slli_epi32( stepX, 4 );
+    depth[i] = _mm512_set1_ps( eEdges.m_pDepth[i] * eEdges.m_fInvArea );
+  }
+  uint64_t iMask = 0;
+  for ( int k = 0; k < iCount; k += 16 ) {
+    const __mmask16 valid  = iCount - k >= 16 ? 0xFFFF : static_cast<__mmask16>( ( 1u << ( iCount - k ) ) - 1 );
+    const __mmask16 inside = _mm512_mask_cmpge_epi32_mask(
+        valid, _mm512_or_si512( _mm512_or_si512( w[0], w[1] ), w[2] ), _mm512_setzero_si512() );
+    if ( inside != 0 ) {
+      const __m512 d = _mm512_add_ps( _mm512_add_ps( _mm512_mul_ps( depth[0], _mm512_cvtepi32_ps( w[0] ) ),
+                                                     _mm512_mul_ps( depth[1], _mm512_cvtepi32_ps( w[1] ) ) ),
+                                      _mm512_mul_ps( depth[2], _mm512_cvtepi32_ps( w[2] ) ) );
+      const __m512    current = _mm512_maskz_loadu_ps( inside, pDepth + k );
+      const __mmask16 pass    = _mm512_mask_cmp_ps_mask( inside, d, current, _CMP_LT_OQ );
+      _mm512_mask_storeu_ps( pDepth + k, pass, d );
+      iMask |= uint64_t( pass ) << k;
+    }
+    for ( int i = 0; i < 3; i++ ) { w[i] = _mm512_add_epi32( w[i], step[i] ); }
+  }
+  return iMask;
+}
+#endif
+
+//! Widest row rasterizer supported by the cpu.
+static RasterRow getRasterRow() {
+#if defined( RASTER_X86 ) && defined( _MSC_VER )
+  int pInfo[4];
+  __cpuid( pInfo, 0 );
+  if ( pInfo[0] >= 7 ) {
+    __cpuid( pInfo, 1 );
+    const uint64_t iXcr0 = ( pInfo[2] & ( 1 << 27 ) ) != 0 ? _xgetbv( 0 ) : 0;  // registers saved by the OS
+    __cpuidex( pInfo, 7, 0 );
+    if ( ( pInfo[1] & ( 1 << 16 ) ) != 0 && ( iXcr0 & 0xe6 ) == 0xe6 ) { return rasterRowAvx512; }
+    if ( ( pInfo[1] & ( 1 << 5 ) ) != 0 && ( iXcr0 & 0x6 ) == 0x6 ) { return rasterRowAvx2; }
+  }
+#elif defined( RASTER_X86 )
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx512f" ) ) { return rasterRowAvx512; }
+  if ( __builtin_cpu_supports( "avx2" ) ) { return rasterRowAvx2; }
+#endif
+  return rasterRow;
+}
+
+static const RasterRow g_pRasterRow = getRasterRow();
+
+static inline int countTrailingZeros( uint64_t iMask ) {
+#ifdef _MSC_VER
+  unsigned long iIndex;
+  _BitScanForward64( &iIndex, iMask );
+  return static_cast<int>( iIndex );
+#else
+  return __builtin_ctzll( iMask );
+#endif
+}
+
+// The shaders are template parameters of the rasterization: their vertex() and fragment() are inlined in the loops
+// compiled for each combination of shader and lighting, selected once per mesh.
+template <bool bLighting>
 struct ShaderMesh {
-  ShaderMesh( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm, bool bLighting ) :
-      m_eMesh( eMesh ), m_eMatMVP( eMatMVP ), m_eMatNrm( eMatNrm ), m_bLighting( bLighting ) {}
-  virtual Vec4 vertex( const int iFace, const int iVertex ) = 0;
-  virtual Vec3 fragment( const Vec3 eCoord )                = 0;
+  ShaderMesh( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm ) :
+      m_eMesh( eMesh ), m_eMatMVP( eMatMVP ), m_eMatNrm( eMatNrm ) {}
+  inline Vec4 transform( const Vertex& vertex, const int iVertex ) {
+    if ( bLighting ) { m_eNorm = glm::column( m_eNorm, iVertex, glm::vec3( m_eMatNrm * vertex.normal_ ) ); }
+    return m_eMatMVP * Vec4( vertex.position_, 1. );
+  }
+  inline Vec3 shade( const Vec3& rgb, const Vec3& eCoord ) const {
+    if ( !bLighting ) { return rgb; }
+    float diff    = std::max( glm::dot( glm::normalize( m_eNorm * eCoord ), m_eLightDirection ), 0.0f );
+    Vec3  ambient = rgb * m_eMaterialAmbient;
+    Vec3  diffuse = rgb * m_eMaterialDiffuse * m_eLightColor * diff;
+    return glm::clamp( ambient + diffuse, 0.0f, 1.0f );
+  }
   Mesh&        m_eMesh;
   Mat4&        m_eMatMVP;
   Mat3         m_eMatNrm;
-  Vec3         m_eLightDirection  = Vec3( 1, 1, 1 );
+  Mat3         m_eNorm;
+  Vec3         m_eLightDirection  = glm::normalize( Vec3( 1, 1, 1 ) );
   Vec3         m_eLightColor      = Vec3( 1, 1, 1 );
   Vec3         m_eMaterialAmbient = Vec3( 0.4, 0.4, 0.4 );
   Vec3         m_eMaterialDiffuse = Vec3( 0.6, 0.6, 0.6 );
-  bool         m_bLighting        = true;
 };
 
-struct ShaderMeshCpv : ShaderMesh {
+template <bool bLighting>
+struct ShaderMeshCpv : ShaderMesh<bLighting> {
   Mat3 m_eColor;
-  Mat3 m_eNorm;
-  ShaderMeshCpv( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm, bool bLighting ) :
-      ShaderMesh( eMesh, eMatMVP, eMatNrm, bLighting ) {}
-  Vec4 vertex( const int iFace, const int iVertex ) {
-    const auto& vertex = m_eMesh.getVertex( m_eMesh.getIndice( iFace * 3 ) + iVertex );
+  ShaderMeshCpv( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm ) : ShaderMesh<bLighting>( eMesh, eMatMVP, eMatNrm ) {}
+  inline Vec4 vertex( const int iFace, const int iVertex ) {
+    const auto& vertex = this->m_eMesh.getVertex( this->m_eMesh.getIndice( iFace * 3 ) + iVertex );
     m_eColor           = glm::column( m_eColor, iVertex, vertex.color_ );
-    if ( m_bLighting ) { m_eNorm = glm::column( m_eNorm, iVertex, glm::vec3( m_eMatNrm * vertex.normal_ ) ); }
-    return m_eMatMVP * Vec4( vertex.position_, 1. );
-  }
-  Vec3 fragment( const Vec3 eCoord ) {
-    Vec3 rgb = m_eColor * eCoord;
-    if ( m_bLighting ) {
-      float diff =
-          std::max( glm::dot( glm::normalize( m_eNorm * eCoord ), glm::normalize( m_eLightDirection ) ), 0.0f );
-      Vec3 ambient = rgb * m_eMaterialAmbient;
-      Vec3 diffuse = rgb * m_eMaterialDiffuse * m_eLightColor * diff;
-      rgb          = glm::clamp( ambient + diffuse, 0.0f, 1.0f );
-    }
-    return rgb;
+    return this->transform( vertex, iVertex );
   }
+  inline Vec3 fragment( const Vec3& eCoord ) const { return this->shade( m_eColor * eCoord, eCoord ); }
 };
 
-struct ShaderMeshMap : ShaderMesh {
-  Mat3x2 m_eUV;
-  Mat3   m_eNorm;
-  ShaderMeshMap( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm, bool bLighting ) :
-      ShaderMesh( eMesh, eMatMVP, eMatNrm, bLighting ) {}
-  Vec4 vertex( const int iFace, const int iVertex ) {
-    const auto& vertex = m_eMesh.getVertex( m_eMesh.getIndice( iFace * 3 ) + iVertex );
+template <bool bLighting>
+struct ShaderMeshMap : ShaderMesh<bLighting> {
+  Mat3x2   m_eUV;
+  Texture* m_pTexture;
+  ShaderMeshMap( Mesh& eMesh, Mat4& eMatMVP, Mat4& eMatNrm ) :
+      ShaderMesh<bLighting>( eMesh, eMatMVP, eMatNrm ), m_pTexture( eMesh.getTextures().data() ) {}
+  inline Vec4 vertex( const int iFace, const int iVertex ) {
+    const auto& vertex = this->m_eMesh.getVertex( this->m_eMesh.getIndice( iFace * 3 ) + iVertex );
     m_eUV              = glm::column( m_eUV, iVertex, vertex.texCoords_ );
-    if ( m_bLighting ) { m_eNorm = glm::column( m_eNorm, iVertex, glm::vec3( m_eMatNrm * vertex.normal_ ) ); }
-    return m_eMatMVP * Vec4( vertex.position_, 1. );
+    return this->transform( vertex, iVertex );
   }
-  Vec3 fragment( const Vec3 eCoord ) {
-    Vec3 rgb = m_eMesh.getTexture( 0 ).texture2DBilinear( m_eUV * eCoord ) / 256.f;
-    if ( m_bLighting ) {
-      float diff =
-          std::max( glm::dot( glm::normalize( m_eNorm * eCoord ), glm::normalize( m_eLightDirection ) ), 0.0f );
-      Vec3 ambient = rgb * m_eMaterialAmbient;
-      Vec3 diffuse = rgb * m_eMaterialDiffuse * m_eLightColor * diff;
-      rgb          = glm::clamp( ambient + diffuse, 0.0f, 1.0f );
-    }
-    return rgb;
+  inline Vec3 fragment( const Vec3& eCoord ) const {
+    return this->shade( m_pTexture->texture2DBilinear( m_eUV * eCoord ) / 256.f, eCoord );
   }
 };
 
 SoftwareRenderer::SoftwareRenderer( Image& image, Mat4& eMatMod, Mat4& eMatPro, bool bLighting ) :
-    m_eMVP( eMatPro * eMatMod ),
-    m_eMatNrm( glm::transpose( glm::inverse( eMatMod ) ) ),
+    m_eMatMod( eMatMod ),
+    m_eMatPro( eMatPro ),
     m_eImage( image ),
     m_bLighting( bLighting ) {
   m_eViewport = Vec4( 0, 0, m_eImage.getWidth(), m_eImage.getHeight() );
+  m_eNumTiles = ( m_eImage.getSize() + g_iTileSize - 1 ) / g_iTileSize;
   m_fDepth.resize( m_eImage.getWidth() * m_eImage.getHeight(), std::numeric_limits<float>::max() );
+  setModel( Mat4( 1.f ) );
 }
 
 SoftwareRenderer::~SoftwareRenderer() { m_fDepth.clear(); }
 
+void SoftwareRenderer::setModel( const Mat4& eModel ) {
+  m_eMVP    = m_eMatPro * m_eMatMod * eModel;
+  m_eMatNrm = glm::transpose( glm::inverse( m_eMatMod * eModel ) );
+}
+
+void SoftwareRenderer::getTile( int iTile, Vec2i& eMin, Vec2i& eMax ) const {
+  eMin = Vec2i( iTile % m_eNumTiles.x, iTile / m_eNumTiles.x ) * g_iTileSize;
+  eMax = glm::min( eMin + g_iTileSize - 1, Vec2i( m_eImage.getWidth(), m_eImage.getHeight() ) - 1 );
+}
+
+template <typename Function>
+void SoftwareRenderer::forEachTile( const ScreenArea& area, const Function& pFunction ) const {
+  if ( area.empty() ) { return; }
+  for ( int y = area.min().y / g_iTileSize; y <= area.max().y / g_iTileSize; y++ ) {
+    for ( int x = area.min().x / g_iTileSize; x <= area.max().x / g_iTileSize; x++ ) {
+      pFunction( x + y * m_eNumTiles.x );
+    }
+  }
+}
+
 void SoftwareRenderer::drawObject( Object& eObject ) {
+  setModel( eObject.getModel() );
   switch ( eObject.getType() ) {
     case ObjectType::MESH: drawObject( *static_cast<ObjectMesh*>( &eObject ) ); break;
     case ObjectType::POINTCLOUD: drawObject( *static_cast<ObjectPointcloud*>( &eObject ) ); break;
   }
 }
 
+template <typename Function>
+void SoftwareRenderer::forShader( Mesh& eMesh, const Function& pFunction ) {
+  if ( eMesh.getUseColorPerVertex() && m_bLighting ) {
+    pFunction( ShaderMeshCpv<true>( eMesh, m_eMVP, m_eMatNrm ) );
+  } else if ( eMesh.getUseColorPerVertex() ) {
+    pFunction( ShaderMeshCpv<false>( eMesh, m_eMVP, m_eMatNrm ) );
+  } else if ( m_bLighting ) {
+    pFunction( ShaderMeshMap<true>( eMesh, m_eMVP, m_eMatNrm ) );
+  } else {
+    pFunction( ShaderMeshMap<false>( eMesh, m_eMVP, m_eMatNrm ) );
+  }
+}
+
 void SoftwareRenderer::drawObject( ObjectMesh& eObject ) {
-  for ( auto& eMesh : eObject.getMeshes() ) {
-    if ( eMesh.getUseColorPerVertex() ) {
-      ShaderMeshCpv shader( eMesh, m_eMVP, m_eMatNrm, m_bLighting );
-      drawMesh( eMesh, shader );
-    } else {
-      ShaderMeshMap shader( eMesh, m_eMVP, m_eMatNrm, m_bLighting );
-      drawMesh( eMesh, shader );
-    }
-  }
-}
-
-void SoftwareRenderer::drawMesh( Mesh& eMesh, ShaderMesh& shader ) {
-  ScreenArea area( m_eImage.getSize() );
-  // printf("drawMesh = vertex = %zu face = %zu \n",eMesh.getNumberOfVertices(),eMesh.getNumberOfFaces() );
-  // fflush(stdout);
-  for ( int f = 0; f < (int)eMesh.getNumberOfFaces(); ++f ) {
-    const Mat3x4 proj( shader.vertex( f, 0 ), shader.vertex( f, 1 ), shader.vertex( f, 2 ) );
-    const Mat3x2 screen = projToScreen( proj );
-    const Vec2   A( screen[1].y - screen[2].y, screen[2].x - screen[1].x );
-    const Vec2   B( screen[2].y - screen[0].y, screen[0].x - screen[2].x );
-    const double invDet = 1. / glm::determinant( Mat2( A, B ) );
-    area.set( screen );
-    // printf(" f = %d => %9d %9d x %9d %9d / image size = %d %d \n",f, area.min().x, area.max().x,  area.min().y,
-    // area.max().y,
-    //   m_eImage.getWidth(),m_eImage.getHeight());
-    // fflush(stdout);
-    for ( int x = area.min().x; x <= area.max().x; x++ ) {
-      for ( int y = area.min().y; y <= area.max().y; y++ ) {
-        const double a = glm::dot( A, Vec2( x, y ) - screen[2] ) * invDet;
-        const double b = glm::dot( B, Vec2( x, y ) - screen[2] ) * invDet;
-        const Vec3   coord( a, b, 1 - a - b );
-        if ( coord[0] >= 0 && coord[1] >= 0 && coord[2] >= 0 ) {
-          float d = glm::dot( glm::row( proj, 2 ), coord );
-          if ( !std::isnan( d ) && d < m_fDepth[x + y * m_eImage.getWidth()] ) {
-            m_fDepth[x + y * m_eImage.getWidth()] = d;
-            m_eImage.set( x, y, shader.fragment( coord ) );
-          }
+  auto& pMeshes = eObject.getMeshes();
+  if ( !m_bDeferredShading ) {
+    for ( auto& eMesh : pMeshes ) {
+      forShader( eMesh, [&]( const auto& shader ) { drawMesh( eMesh, shader ); } );
+    }
+    return;
+  }
+  // Visibility pass: with a depth complexity of 3 to 5, most of the shaded pixels of the forward rendering are
+  // overwritten, here only the depth, the mesh, the face and the barycentric coordinates are written.
+  const int iWidth = m_eImage.getWidth(), iNumMeshes = static_cast<int>( pMeshes.size() );
+  m_pVisibility.assign( m_fDepth.size(), Visibility{ -1, -1, { 0.f, 0.f } } );
+  for ( int m = 0; m < iNumMeshes; m++ ) {
+    forShader( pMeshes[m], [&]( const auto& shader ) { drawMesh( pMeshes[m], shader, m ); } );
+  }
+  // Shading pass: the visible pixels of each tile are sorted by mesh, so by texture, in memory order, and each mesh
+  // shades its pixels with its shader.
+  runTasks( m_eNumTiles.x * m_eNumTiles.y, [&]( int t ) {
+    Vec2i            eTileMin, eTileMax;
+    std::vector<int> pCount( iNumMeshes + 1, 0 ), pPixels;
+    getTile( t, eTileMin, eTileMax );
+    for ( int y = eTileMin.y; y <= eTileMax.y; y++ ) {
+      for ( int x = eTileMin.x; x <= eTileMax.x; x++ ) { pCount[m_pVisibility[x + y * iWidth].m_iMesh + 1]++; }
+    }
+    std::vector<int> pOffset( iNumMeshes + 1, 0 );
+    for ( int m = 1; m <= iNumMeshes; m++ ) { pOffset[m] = pOffset[m - 1] + pCount[m - 1]; }
+    pPixels.resize( pOffset[iNumMeshes] + pCount[iNumMeshes] );
+    for ( int y = eTileMin.y; y <= eTileMax.y; y++ ) {
+      for ( int x = eTileMin.x; x <= eTileMax.x; x++ ) {
+        pPixels[pOffset[m_pVisibility[x + y * iWidth].m_iMesh + 1]++] = x + y * iWidth;
+      }
+    }
+    for ( int m = 0; m < iNumMeshes; m++ ) {
+      if ( pCount[m + 1] == 0 ) { continue; }
+      const int* pMeshPixels = pPixels.data() + pOffset[m + 1] - pCount[m + 1];
+      forShader( pMeshes[m], [&]( const auto& shader ) { shadePixels( shader, pMeshPixels, pCount[m + 1] ); } );
+    }
+  } );
+}
+
+template <typename Shader>
+void SoftwareRenderer::shadePixels( const Shader& shader, const int* pPixels, size_t iCount ) {
+  Shader    eShader( shader );
+  const int iWidth = m_eImage.getWidth();
+  int       iFace  = -1;
+  for ( size_t i = 0; i < iCount; i++ ) {
+    const Visibility& eVisibility = m_pVisibility[pPixels[i]];
+    if ( eVisibility.m_iFace != iFace ) {
+      iFace = eVisibility.m_iFace;
+      for ( int v = 0; v < 3; v++ ) { eShader.vertex( iFace, v ); }
+    }
+    const Vec3 coord( eVisibility.m_fCoord[0], eVisibility.m_fCoord[1],
+                      1.f - eVisibility.m_fCoord[0] - eVisibility.m_fCoord[1] );
+    m_eImage.set( pPixels[i] % iWidth, pPixels[i] / iWidth, eShader.fragment( coord ) );
+  }
+}
+
+template <typename Shader>
+void SoftwareRenderer::drawMesh( Mesh& eMesh, const Shader& shader, int iMesh ) {
+  const int iNumFaces  = (int)eMesh.getNumberOfFaces();
+  const int iNumChunks = ( iNumFaces + g_iChunkSize - 1 ) / g_iChunkSize;
+  const int iNumTiles  = m_eNumTiles.x * m_eNumTiles.y;
+  Bins      pBins( iNumChunks, std::vector<std::vector<int> >( iNumTiles ) );
+  // Each task shades with its own copy of the shader: vertex() keeps the attributes of the current face.
+  runTasks( iNumChunks, [&]( int c ) {
+    Shader     eShader( shader );
+    ScreenArea area( m_eImage.getSize() );
+    for ( int f = c * g_iChunkSize; f < ( std::min )( iNumFaces, ( c + 1 ) * g_iChunkSize ); ++f ) {
+      area.set( projToScreen( Mat3x4( eShader.vertex( f, 0 ), eShader.vertex( f, 1 ), eShader.vertex( f, 2 ) ) ) );
+      forEachTile( area, [&]( int t ) { pBins[c][t].push_back( f ); } );
+    }
+  } );
+  runTasks( iNumTiles, [&]( int t ) {
+    Shader     eShader( shader );
+    ScreenArea area( m_eImage.getSize() );
+    Vec2i      eTileMin, eTileMax;
+    getTile( t, eTileMin, eTileMax );
+    for ( int c = 0; c < iNumChunks; c++ ) {
+      for ( int f : pBins[c][t] ) {
+        const Mat3x4 proj( eShader.vertex( f, 0 ), eShader.vertex( f, 1 ), eShader.vertex( f, 2 ) );
+        area.set( projToScreen( proj ) );
+        area.clip( eTileMin, eTileMax );
+        if ( area.empty() ) { continue; }
+        if ( iMesh < 0 ) {
+          drawTriangle( proj, area.min(), area.max(), [&]( int x, int y, const Vec3& coord ) {
+            m_eImage.set( x, y, eShader.fragment( coord ) );
+          } );
+        } else {
+          drawTriangle( proj, area.min(), area.max(), [&]( int x, int y, const Vec3& coord ) {
+            m_pVisibility[x + y * m_eImage.getWidth()] = Visibility{ iMesh, f, { coord[0], coord[1] } };
+          } );
+        }
+      }
+    }
+  } );
+}
+
+template <typename Output>
+void SoftwareRenderer::drawTriangle( const Mat3x4& proj, const Vec2i& eMin, const Vec2i& eMax, const Output& pOutput ) {
+  const Mat3x2 screen = projToScreen( proj );
+  const int    iWidth = m_eImage.getWidth();
+  // Vertices in fixed point relative to the first pixel of the area.
+  int64_t pX[3], pY[3];
+  bool    bGuardBand = true;
+  for ( int i = 0; i < 3 && bGuardBand; i++ ) {
+    const double dX = ( screen[i].x - eMin.x ) * g_iSubPixel, dY = ( screen[i].y - eMin.y ) * g_iSubPixel;
+    bGuardBand      = std::abs( dX ) < g_iGuardBand && std::abs( dY ) < g_iGuardBand;
+    if ( bGuardBand ) {
+      pX[i] = std::llround( dX );
+      pY[i] = std::llround( dY );
+    }
+  }
+  if ( bGuardBand ) {
+    // The edge function of the edge opposite to a vertex is its barycentric coordinate times twice the area.
+    const int64_t iArea = ( pX[2] - pX[1] ) * ( pY[0] - pY[1] ) - ( pY[2] - pY[1] ) * ( pX[0] - pX[1] );
+    if ( iArea == 0 ) { return; }
+    const int32_t iSign = iArea > 0 ? 1 : -1;
+    Edges         eEdges;
+    for ( int i = 0; i < 3; i++ ) {
+      const int j = ( i + 1 ) % 3, k = ( i + 2 ) % 3;
+      eEdges.m_pW[i]     = static_cast<int32_t>( iSign * ( ( pY[k] - pY[j] ) * pX[j] - ( pX[k] - pX[j] ) * pY[j] ) );
+      eEdges.m_pStepX[i] = static_cast<int32_t>( iSign * -( pY[k] - pY[j] ) * g_iSubPixel );
+      eEdges.m_pStepY[i] = static_cast<int32_t>( iSign * ( pX[k] - pX[j] ) * g_iSubPixel );
+      eEdges.m_pDepth[i] = proj[i][2];
+    }
+    eEdges.m_fInvArea = 1.f / static_cast<float>( iSign * iArea );
+    for ( int y = eMin.y; y <= eMax.y; y++ ) {
+      uint64_t iMask = g_pRasterRow( eEdges, &m_fDepth[eMin.x + y * iWidth], eMax.x - eMin.x + 1 );
+      while ( iMask != 0 ) {
+        const int k = countTrailingZeros( iMask );
+        iMask &= iMask - 1;
+        const Vec3 coord( static_cast<float>( eEdges.m_pW[0] + k * eEdges.m_pStepX[0] ) * eEdges.m_fInvArea,
+                          static_cast<float>( eEdges.m_pW[1] + k * eEdges.m_pStepX[1] ) * eEdges.m_fInvArea,
+                          static_cast<float>( eEdges.m_pW[2] + k * eEdges.m_pStepX[2] ) * eEdges.m_fInvArea );
+        pOutput( eMin.x + k, y, coord );
+      }
+      for ( int i = 0; i < 3; i++ ) { eEdges.m_pW[i] += eEdges.m_pStepY[i]; }
+    }
+    return;
+  }
+  const Vec2   A( screen[1].y - screen[2].y, screen[2].x - screen[1].x );
+  const Vec2   B( screen[2].y - screen[0].y, screen[0].x - screen[2].x );
+  const double invDet = 1. / glm::determinant( Mat2( A, B ) );
+  for ( int y = eMin.y; y <= eMax.y; y++ ) {
+    for ( int x = eMin.x; x <= eMax.x; x++ ) {
+      const double a = glm::dot( A, Vec2( x, y ) - screen[2] ) * invDet;
+      const double b = glm::dot( B, Vec2( x, y ) - screen[2] ) * invDet;
+      const Vec3   coord( a, b, 1 - a - b );
+      if ( coord[0] >= 0 && coord[1] >= 0 && coord[2] >= 0 ) {
+        float d = glm::dot( glm::row( proj, 2 ), coord );
+        if ( !std::isnan( d ) && d < m_fDepth[x + y * iWidth] ) {
+          m_fDepth[x + y * iWidth] = d;
+          pOutput( x, y, coord );
         }
       }
     }
@@ -134,26 +439,47 @@ void SoftwareRenderer::drawMesh( Mesh& eMesh, ShaderMesh& shader ) {
 }
 
 void SoftwareRenderer::drawObject( ObjectPointcloud& eObject ) {
-  ScreenArea area( m_eImage.getSize() );
-  for ( int i = 0; i < (int)eObject.getNumPoints(); ++i ) {
-    const Vec4 proj   = m_eMVP * Vec4( eObject.getPoints( i ), 1.f );
-    const Vec2 screen = projToScreen( proj );
-    area.set( screen, 500.f / proj[3] );
-    for ( int x = area.min().x; x <= area.max().x; x++ ) {
-      for ( int y = area.min().y; y <= area.max().y; y++ ) {
-        if ( !std::isnan( proj[2] ) && proj[2] < m_fDepth[x + y * m_eImage.getWidth()] ) {
-          m_fDepth[x + y * m_eImage.getWidth()] = (float)proj[2];
-          m_eImage.set( x, y, eObject.getColors3( i ) );
+  PointMemory::getInstance().recordAccess( eObject.getPoints(), eObject.getNumPoints() * sizeof( Point ) );
+  const int         iNumPoints = (int)eObject.getNumPoints();
+  const int         iNumChunks = ( iNumPoints + g_iChunkSize - 1 ) / g_iChunkSize;
+  const int         iNumTiles  = m_eNumTiles.x * m_eNumTiles.y;
+  std::vector<Vec4> pProj( iNumPoints );
+  Bins              pBins( iNumChunks, std::vector<std::vector<int> >( iNumTiles ) );
+  runTasks( iNumChunks, [&]( int c ) {
+    ScreenArea area( m_eImage.getSize() );
+    for ( int i = c * g_iChunkSize; i < ( std::min )( iNumPoints, ( c + 1 ) * g_iChunkSize ); ++i ) {
+      pProj[i] = m_eMVP * Vec4( eObject.getPoints( i ), 1.f );
+      if ( std::isnan( pProj[i][2] ) ) { continue; }
+      area.set( projToScreen( pProj[i] ), 500.f / pProj[i][3] );
+      forEachTile( area, [&]( int t ) { pBins[c][t].push_back( i ); } );
+    }
+  } );
+  runTasks( iNumTiles, [&]( int t ) {
+    ScreenArea area( m_eImage.getSize() );
+    Vec2i      eTileMin, eTileMax;
+    getTile( t, eTileMin, eTileMax );
+    for ( int c = 0; c < iNumChunks; c++ ) {
+      for ( int i : pBins[c][t] ) {
+        const Vec4& proj = pProj[i];
+        area.set( projToScreen( proj ), 500.f / proj[3] );
+        area.clip( eTileMin, eTileMax );
+        for ( int y = area.min().y; y <= area.max().y; y++ ) {
+          for ( int x = area.min().x; x <= area.max().x; x++ ) {
+            if ( proj[2] < m_fDepth[x + y * m_eImage.getWidth()] ) {
+              m_fDepth[x + y * m_eImage.getWidth()] = (float)proj[2];
+              m_eImage.set( x, y, eObject.getColors3u8( i ) );
+            }
+          }
         }
       }
     }
-  }
+  } );
 }
 
 void SoftwareRenderer::drawBackground( Color3 eColor ) { m_eImage.fill( eColor ); }
 
 void SoftwareRenderer::drawFloor( Box eFloor, Color4& eColor ) {
   Mesh          eMesh( eFloor, eColor );
-  ShaderMeshCpv shader( eMesh, m_eMVP, m_eMatNrm, m_bLighting );
-  drawMesh( eMesh, shader );
+  setModel( Mat4( 1.f ) );
+  forShader( eMesh, [&]( const auto& shader ) { drawMesh( eMesh, shader ); } );
 }
\ No newline at end of file
@@ -7,6 +7,11 @@
 #include "PccRendererParameters.h"
 #include "PccRendererSoftwareRenderer.h"
 #include "PccRendererImage.h"
+#include "PccRendererPointMemory.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 Window::Window( std::string name, RendererParameters& params ) : m_sWindowName( name ) {
   m_iWidth            = params.getWidth();
@@ -222,6 +227,7 @@ void Window::drawObject() {
     rotate              = glm::rotate( rotate, glm::radians( m_eSceneRotation[2] ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
     glm::mat4 mat       = m_eMatMod * rotate * translate * scale;
     programScene.setUniform( "ModMat", mat );
+    programScene.setUniform( "ObjMat", eScene.getModel() );
     programScene.setUniform( "ProjMat", m_eMatPro );
     programScene.setUniform( "forceColor", static_cast<float>( m_iForceColor ) );
     glLineWidth( m_fPointSize );
@@ -236,7 +242,9 @@ void Window::drawObject() {
     glEnable( GL_DEPTH_TEST );
   }
   auto& eObject = m_pcSequence->getObject();
-  eObject.setCameraPosition( m_eCamera.getPosition() );
+  // The points are in the space of the object, transformed by its model matrix (normalization of the sequence).
+  const Vec3 eCameraPosition = Vec3( glm::inverse( eObject.getModel() ) * Vec4( m_eCamera.getPosition(), 1.f ) );
+  eObject.setCameraPosition( eCameraPosition );
   eObject.setMultiColorIndex( m_iMultiColorIndex );
   glEnable( GL_PROGRAM_POINT_SIZE );
   glDisable( GL_BLEND );
@@ -246,12 +254,13 @@ void Window::drawObject() {
   auto& program = m_pcSequence->getProgram();
   program.use();
   program.setUniform( "ModMat", m_eMatMod );
+  program.setUniform( "ObjMat", eObject.getModel() );
   program.setUniform( "ProjMat", m_eMatPro );
   program.setUniform( "forceColor", static_cast<float>( m_iForceColor ) );
   if ( eObject.getType() == ObjectType::POINTCLOUD ) {
     program.setUniform( "PointSize", m_fPointSize );
     if ( m_pcSequence->getProgramIndex() == 0 ) { program.setUniform( "DepthMap", static_cast<int>( m_bDepthMap ) ); }
-    program.setUniform( "posCamera", m_eCamera.getPosition() );
+    program.setUniform( "posCamera", eCameraPosition );
     if ( m_pcSequence->getProgramIndex() == 3 ) { 
         eObject.sortVertex(m_eCamera);
         program.setUniform("iBlendMode", m_iBlendMode);
@@ -294,13 +303,15 @@ void Window::drawElements() {
     m_eAxes.draw( m_eMatMod, m_eMatPro );
   }
   if ( m_bDrawBox ) {
-    m_eCubes.load( m_pcSequence->getBoxSize(), m_pcSequence->getObject().getBox(), m_pcSequence->getBox() );
+    Box eObjectBox = m_pcSequence->getObject().getModelBox();
+    m_eCubes.load( m_pcSequence->getBoxSize(), eObjectBox, m_pcSequence->getBox() );
     m_eCubes.draw( m_eMatMod, m_eMatPro );
     std::vector<Vec3>   points, direction;
     std::vector<Color3> color;
     m_pcSequence->getObject().getRigPoints( points, color, direction );
     m_ePointList.load( points, color, direction );
-    m_ePointList.draw( m_eMatMod, m_eMatPro, 25, true );
+    Mat4 eMatObj = m_eMatMod * m_pcSequence->getObject().getModel();
+    m_ePointList.draw( eMatObj, m_eMatPro, 25, true );
   }
   if ( !m_bHelp && ( ( ( m_iDisplayMetric > 0 ) && m_pcSequence->getHaveSource() ) || m_bDisplayDuplicate ) ) {
     m_eDistanceScale.load();
@@ -337,8 +348,10 @@ void Window::load() {
     m_iDisplayMetric = 0;
   }
   if ( m_iTypeColor > 0 && m_pcSequence->getTypeName().empty() ) { m_iTypeColor = 0; }
+  m_pcSequence->requestAttributes( ( m_iTypeColor > 0 ? ATTRIBUTE_TYPE : 0 ) |
+                                   ( m_iMultiColorIndex != -3 ? ATTRIBUTE_MULTI_COLOR : 0 ) );
   m_pcSequence->setDisplaySource( m_bDisplaySrc );
-  m_pcSequence->unload();
+  m_pcSequence->unload( !m_bReload );
   auto& eObject = m_pcSequence->getObject();
   eObject.setDisplayMetric( m_iDisplayMetric );
   eObject.setDisplayDuplicate( m_bDisplayDuplicate );
@@ -552,23 +565,98 @@ void Window::updateMatrix() {
 }
 
 void Window::softwareRendering() {
-  std::vector<Image> eImages;
-  eImages.resize( m_eCameraPath.getMaxIndex() );
-#pragma omp parallel for
-  for ( int i = 0; i < m_eCameraPath.getMaxIndex(); i++ ) {
+  // The images are rendered out of order by the threads in a reorder buffer of iDepth images, and written in order by
+  // a writer thread as soon as they are contiguous: the memory does not depend on the length of the camera path and
+  // the output file is written during the rendering. A thread only starts an image of the window of the iDepth images
+  // following the last written one, so the next image to write is always rendered first and the slot of an image
+  // ( i % iDepth ) is free when it starts.
+  // In the window, the threads render the images of the NUMA node of the points of their frame first, then help the
+  // other nodes. In streaming mode, the frames are loaded following the playback order and all the nodes are 0.
+#ifdef _OPENMP
+  const int iNumThreads = omp_get_max_threads();
+#else
+  const int iNumThreads = ( std::max )( static_cast<int>( std::thread::hardware_concurrency() ), 1 );
+#endif
+  auto&                   eMemory    = PointMemory::getInstance();
+  const int               iNumImages = m_eCameraPath.getMaxIndex();
+  const int               iDepth     = ( std::min )( m_iReorderDepth > 0 ? m_iReorderDepth : 2 * iNumThreads,
+                                                     ( std::max )( iNumImages, 1 ) );
+  const bool              bNodes     = !m_pcSequence->getStreaming() && eMemory.getNumNodes() > 1;
+  std::vector<int>        pNodes( iNumImages, 0 );
+  std::vector<char>       pStates( iNumImages, 0 );  // 0: waiting, 1: rendering, 2: rendered
+  int                     iNumStarted = 0, iNumWritten = 0;
+  std::vector<Image>      eImages( iDepth );
+  std::mutex              eMutex;
+  std::condition_variable eRendered, eWritten;
+  for ( int i = 0; i < iNumImages && bNodes; i++ ) {
+    pNodes[i] = m_pcSequence->getFrameNode( m_bPause ? 0 : i % m_pcSequence->getNumFrames() );
+  }
+  std::thread eWriter( [&]() {
+    for ( int i = 0; i < iNumImages; i++ ) {
+      {
+        std::unique_lock<std::mutex> eLock( eMutex );
+        eRendered.wait( eLock, [&]() { return pStates[i] == 2; } );
+      }
+      eImages[i % iDepth].write( m_pOutputRgbFile );
+      {
+        std::lock_guard<std::mutex> eLock( eMutex );
+        iNumWritten++;
+      }
+      eWritten.notify_all();
+    }
+  } );
+  // Next image of the window for a thread of the node iNode, -1 when all the images are started.
+  auto startImage = [&]( int iNode ) {
+    std::unique_lock<std::mutex> eLock( eMutex );
+    int                          iImage = -1;
+    eWritten.wait( eLock, [&]() {
+      const int iEnd = ( std::min )( iNumWritten + iDepth, iNumImages );
+      for ( int i = iNumWritten; i < iEnd; i++ ) {
+        if ( pStates[i] != 0 ) { continue; }
+        if ( iImage < 0 ) { iImage = i; }
+        if ( pNodes[i] == iNode ) {
+          iImage = i;
+          break;
+        }
+      }
+      return iImage >= 0 || iNumStarted == iNumImages;
+    } );
+    if ( iImage >= 0 ) {
+      pStates[iImage] = 1;
+      iNumStarted++;
+    }
+    return iImage;
+  };
+  auto renderImage = [&]( int i ) {
     CameraPath eCameraPath = m_eCameraPath;
     Vec3       eEye, eCenter, eUp;
-    eImages[i].allocate( m_iWidth, m_iHeight );
+    Image&     eImage = eImages[i % iDepth];
+    eImage.allocate( m_iWidth, m_iHeight );
     eCameraPath.setIndex( i );
     eCameraPath.getPose( eEye, eCenter, eUp, m_bSpline, m_bOrthographic );
     auto             eMatMod = glm::lookAt( eEye, eCenter, eUp );
     auto             eMatPro = getMatPro();
-    SoftwareRenderer renderer( eImages[i], eMatMod, eMatPro, m_bLighting );
+    SoftwareRenderer renderer( eImage, eMatMod, eMatPro, m_bLighting );
+    renderer.setDeferredShading( m_bDeferredShading );
     renderer.drawBackground( m_eBackgroundColor );
     if ( m_bFloor ) { renderer.drawFloor( m_pcSequence->getFloor(), m_eFloorColor ); }
-    renderer.drawObject( m_pcSequence->getObject( m_bPause ? 0 : i % m_pcSequence->getNumFrames() ) );
+    int iFrameIndex = m_bPause ? 0 : i % m_pcSequence->getNumFrames();
+    renderer.drawObject( m_pcSequence->acquireObject( iFrameIndex ) );
+    m_pcSequence->releaseObject( iFrameIndex );
+    {
+      std::lock_guard<std::mutex> eLock( eMutex );
+      pStates[i] = 2;
+    }
+    eRendered.notify_one();
+  };
+#pragma omp parallel
+  {
+    const int iNode = bNodes ? eMemory.getCurrentNode() : 0;
+    for ( int i = startImage( iNode ); i >= 0; i = startImage( iNode ) ) { renderImage( i ); }
   }
-  for ( auto& eImage : eImages ) { eImage.write( m_pOutputRgbFile ); }
+  eWriter.join();
+  fflush( m_pOutputRgbFile );
+  eMemory.printStats();
 }
 
 void Window::saveYuv( FILE* pFile ) {
@@ -736,6 +824,8 @@ void Window::set( RendererParameters& params ) {
   m_iAlign            = params.getAlign();
   m_iCameraPathIndex  = params.getCameraPathIndex();
   m_bLighting         = params.getLighting();
+  m_iReorderDepth     = params.getReorderDepth();
+  m_bDeferredShading  = params.getDeferredShading();
 
   if (!params.getViewpointFile().empty()) { m_sViewpointFile = params.getViewpointFile(); m_bViewPoint = true; }
   if ( !params.getCameraPathFile().empty() ) {
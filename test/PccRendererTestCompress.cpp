@@ -0,0 +1,71 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererTestFrame.h"
+
+// Round trip of ObjectPointcloud::compress() and decompress(): the frames kept compressed in memory in streaming mode
+// must be restored bit exact, and the truncated buffers must be rejected.
+
+//! Positions on an integer grid as the voxelized contents or floats. A -0 coordinate is set in a chunk of the frames of
+//! several chunks: it must be restored as -0.
+static Point getPosition( int i, bool bInteger, std::mt19937& eRandom ) {
+  std::uniform_int_distribution<int>    eCoordinate( 0, 1023 );
+  std::uniform_real_distribution<float> eFloat( -100.f, 100.f );
+  Point ePoint = bInteger ? Point( eCoordinate( eRandom ), eCoordinate( eRandom ), eCoordinate( eRandom ) )
+                          : Point( eFloat( eRandom ), eFloat( eRandom ), eFloat( eRandom ) );
+  if ( i == 100000 ) { ePoint[1] = -0.f; }
+  return ePoint;
+}
+
+static bool isSameArray( const void* pData0, const void* pData1, size_t iSize ) {
+  return iSize == 0 || memcmp( pData0, pData1, iSize ) == 0;
+}
+
+static bool checkCompress( int iNumPoints, bool bAlpha, bool bInteger, size_t iNumMultiColors ) {
+  ObjectPointcloud     eSource, eFrame;
+  std::vector<uint8_t> pBuffer;
+  auto                 getPoint = [&]( int i, std::mt19937& eRandom ) { return getPosition( i, bInteger, eRandom ); };
+  createFrame( eSource, iNumPoints, bAlpha, iNumMultiColors, 1234, getPoint );
+  createFrame( eFrame, iNumPoints, bAlpha, iNumMultiColors, 1234, getPoint );
+  eFrame.compress( pBuffer );
+  eFrame.release();
+  const size_t iNumPoints0 = static_cast<size_t>( iNumPoints );
+  bool         bSame       = eFrame.decompress( pBuffer );
+  bSame = bSame && eFrame.getNumPoints() == iNumPoints0 && eFrame.getAlpha() == bAlpha && eFrame.getNormal() &&
+          eFrame.getHasType() && eFrame.getNumMultiColors() == iNumMultiColors;
+  bSame = bSame && isSameArray( eFrame.getPoints(), eSource.getPoints(), iNumPoints0 * sizeof( Point ) ) &&
+          isSameArray( eFrame.getColors(), eSource.getColors(),
+                       iNumPoints0 * ( bAlpha ? sizeof( Color4u8 ) : sizeof( Color3u8 ) ) ) &&
+          isSameArray( eFrame.getNormals(), eSource.getNormals(), iNumPoints0 * sizeof( Normal ) ) &&
+          isSameArray( eFrame.getTypes(), eSource.getTypes(), iNumPoints0 * sizeof( uint8_t ) ) &&
+          isSameArray( eFrame.getMultiColors3().data(), eSource.getMultiColors3().data(),
+                       iNumPoints0 * iNumMultiColors * sizeof( Color3u8 ) );
+  for ( size_t k = 0; bSame && k < iNumMultiColors; k++ ) {
+    for ( int i = 0; i < 4; i++ ) {
+      for ( int j = 0; j < 4; j++ ) {
+        bSame = bSame && eFrame.getRigParameters().getMatrix( k )[i][j] ==
+                             eSource.getRigParameters().getMatrix( k )[i][j];
+      }
+    }
+  }
+  // A truncated buffer is rejected.
+  const size_t iSize = pBuffer.size();
+  pBuffer.resize( iSize - 1 );
+  const bool bTruncated = !eFrame.decompress( pBuffer );
+  printf( "Compress: %d points, alpha = %d, integer = %d, multi colors = %zu: %zu bytes: %s \n", iNumPoints, bAlpha,
+          bInteger, iNumMultiColors, iSize, bSame && bTruncated ? "ok" : "FAILED" );
+  return bSame && bTruncated;
+}
+
+int main() {
+  bool bSuccess = true;
+  // Several chunks of 2^16 points are compressed in parallel.
+  for ( int iNumPoints : {1, 1000, 150000} ) {
+    for ( bool bAlpha : {false, true} ) {
+      for ( bool bInteger : {true, false} ) { bSuccess = checkCompress( iNumPoints, bAlpha, bInteger, 0 ) && bSuccess; }
+    }
+  }
+  bSuccess = checkCompress( 1000, false, true, 3 ) && bSuccess;
+  return bSuccess ? 0 : 1;
+}
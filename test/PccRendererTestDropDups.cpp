@@ -0,0 +1,96 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#include "PccRendererTestFrame.h"
+
+#include <numeric>
+#include <tuple>
+
+// Equivalence of ObjectPointcloud::removeDuplicatePoints() and of a sequential sort-based reference: the same first
+// occurrences are kept in the same order, with the same averaged colors in the average mode.
+
+//! Many duplicate positions: a small integer grid, a few positions off the grid and some -0.
+static Point getPosition( std::mt19937& eRandom ) {
+  std::uniform_int_distribution<int> eCoordinate( -20, 20 ), eCase( 0, 15 );
+  Point                              ePoint( eCoordinate( eRandom ), eCoordinate( eRandom ), eCoordinate( eRandom ) );
+  int                                iCase = eCase( eRandom );
+  if ( iCase == 0 ) { ePoint[0] += 0.25f; }
+  if ( iCase == 1 && ePoint[1] == 0.f ) { ePoint[1] = -0.f; }
+  return ePoint;
+}
+
+//! Reference: the points sorted by position, each group of equal positions is replaced by its first occurrence.
+static void removeDuplicateReference( ObjectPointcloud&      eFrame,
+                                      int                    iDropDups,
+                                      std::vector<int>&      pKept,
+                                      std::vector<Color4u8>& pColors ) {
+  const int        iNumPoints = static_cast<int>( eFrame.getNumPoints() );
+  std::vector<int> pOrder( iNumPoints );
+  std::iota( pOrder.begin(), pOrder.end(), 0 );
+  auto getKey = [&]( int i ) {
+    const Point& ePoint = eFrame.getPoints( i );
+    return std::make_tuple( ePoint[0], ePoint[1], ePoint[2] );
+  };
+  std::stable_sort( pOrder.begin(), pOrder.end(), [&]( int i, int j ) { return getKey( i ) < getKey( j ); } );
+  std::vector<Color4u8> pAverage( iNumPoints );
+  std::vector<bool>     pFirst( iNumPoints, false );
+  for ( int iStart = 0, iEnd = 0; iStart < iNumPoints; iStart = iEnd ) {
+    uint32_t pSum[4] = {0, 0, 0, 0};
+    for ( iEnd = iStart; iEnd < iNumPoints && getKey( pOrder[iEnd] ) == getKey( pOrder[iStart] ); iEnd++ ) {
+      Color4 eColor = eFrame.getColors4( pOrder[iEnd] ) * 255.f;
+      for ( int c = 0; c < 4; c++ ) { pSum[c] += static_cast<uint32_t>( eColor[c] + 0.5f ); }
+    }
+    const int   iFirst  = pOrder[iStart];
+    const float fNumber = static_cast<float>( iEnd - iStart );
+    pFirst[iFirst]      = true;
+    pAverage[iFirst]    = toColor8Bit( eFrame.getColors4( iFirst ) * 255.f );
+    if ( iDropDups == 2 && iEnd - iStart > 1 ) {
+      pAverage[iFirst] = eFrame.getAlpha()
+                             ? toColor8Bit( Color4( pSum[0], pSum[1], pSum[2], pSum[3] ) / fNumber )
+                             : Color4u8( toColor8Bit( Color3( pSum[0], pSum[1], pSum[2] ) / fNumber ), 255 );
+    }
+  }
+  pKept.clear();
+  pColors.clear();
+  for ( int i = 0; i < iNumPoints; i++ ) {
+    if ( !pFirst[i] ) { continue; }
+    pKept.push_back( i );
+    pColors.push_back( pAverage[i] );
+  }
+}
+
+static bool checkDropDups( int iNumPoints, bool bAlpha, int iDropDups ) {
+  ObjectPointcloud eSource, eFrame;
+  auto             getPoint = []( int, std::mt19937& eRandom ) { return getPosition( eRandom ); };
+  createFrame( eSource, iNumPoints, bAlpha, 0, 1234, getPoint );
+  createFrame( eFrame, iNumPoints, bAlpha, 0, 1234, getPoint );
+  std::vector<int>      pKept;
+  std::vector<Color4u8> pColors;
+  removeDuplicateReference( eSource, iDropDups, pKept, pColors );
+  eFrame.removeDuplicatePoints( iDropDups );
+  bool bSame = eFrame.getNumPoints() == pKept.size() &&
+               eFrame.getNumDuplicate() == iNumPoints - static_cast<int>( pKept.size() );
+  for ( size_t i = 0; bSame && i < pKept.size(); i++ ) {
+    const int iSource = pKept[i];
+    Color4u8  eColor  = toColor8Bit( eFrame.getColors4( i ) * 255.f );
+    bSame = eFrame.getPoints( i ) == eSource.getPoints( iSource ) && eColor == pColors[i] &&
+            eFrame.getNormals()[i] == eSource.getNormals()[iSource] &&
+            eFrame.getTypes()[i] == eSource.getTypes()[iSource];
+    if ( !bSame ) { printf( "  point %zu differs from the source point %d \n", i, iSource ); }
+  }
+  printf( "DropDups: %d points, alpha = %d, dropdups = %d: %zu points kept: %s \n", iNumPoints, bAlpha, iDropDups,
+          pKept.size(), bSame ? "ok" : "FAILED" );
+  return bSame;
+}
+
+int main() {
+  bool bSuccess = true;
+  // Several chunks of 2^16 points are dispatched in the buckets.
+  for ( int iNumPoints : {1, 1000, 200000} ) {
+    for ( bool bAlpha : {false, true} ) {
+      for ( int iDropDups : {1, 2} ) { bSuccess = checkDropDups( iNumPoints, bAlpha, iDropDups ) && bSuccess; }
+    }
+  }
+  return bSuccess ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+//Copyright(c) 2016 - 2025, InterDigital
+//All rights reserved.
+//See LICENSE under the root folder.
+
+#ifndef _TEST_FRAME_RENDERER_APP_H_
+#define _TEST_FRAME_RENDERER_APP_H_
+
+#include "PccRendererDef.h"
+#include "PccRendererObjectPointcloud.h"
+
+#include <random>
+
+/**
+ * \brief create a random frame with all the attributes: colors, normals, types and iNumMultiColors multi colors with
+ * their rig matrices.
+ * \param getPosition Position of the point i, Point( int i, std::mt19937& eRandom ): the frames created with the same
+ * seed are identical.
+ */
+template <typename Position>
+void createFrame( ObjectPointcloud& eFrame,
+                  int               iNumPoints,
+                  bool              bAlpha,
+                  size_t            iNumMultiColors,
+                  unsigned int      iSeed,
+                  const Position&   getPosition ) {
+  std::mt19937                          eRandom( iSeed );
+  std::uniform_int_distribution<int>    eComponent( 0, 255 ), eType( 0, 3 );
+  std::uniform_real_distribution<float> eFloat( -100.f, 100.f );
+  eFrame.setAttributes( ATTRIBUTE_ALL );
+  eFrame.getRigParameters().setCount( iNumMultiColors );
+  for ( size_t k = 0; k < iNumMultiColors; k++ ) {
+    for ( int i = 0; i < 4; i++ ) {
+      for ( int j = 0; j < 4; j++ ) { eFrame.getRigParameters().getMatrix( k )[i][j] = eFloat( eRandom ); }
+    }
+  }
+  eFrame.getRigParameters().setFrameToWorldScale( 2.f );
+  eFrame.allocate( bAlpha, true, true, iNumPoints, 0, 0 );
+  for ( int i = 0; i < iNumPoints; i++ ) {
+    Point  ePoint = getPosition( i, eRandom );
+    Color4 eColor( eComponent( eRandom ), eComponent( eRandom ), eComponent( eRandom ), eComponent( eRandom ) );
+    Normal eNormal( eFloat( eRandom ), eFloat( eRandom ), eFloat( eRandom ) );
+    eFrame.add( ePoint, eColor, eNormal, static_cast<uint8_t>( eType( eRandom ) ) );
+    for ( size_t k = 0; k < iNumMultiColors; k++ ) {
+      eFrame.setMultiColors3( i, k, Color3( eComponent( eRandom ), eComponent( eRandom ), eComponent( eRandom ) ) );
+    }
+  }
+}
+
+#endif  //~_TEST_FRAME_RENDERER_APP_H_